@@ -9,7 +9,10 @@
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
+#include <cmath>
 #include <unordered_map>
+#include <vector>
 
 #define N 1ull << 20
 
@@ -39,6 +42,24 @@ template< typename Container > static void container_find(benchmark::State& stat
     state.SetItemsProcessed(result ? state.iterations() * state.range() : 0);
 }
 
+template< typename Container > static void container_find_batch(benchmark::State& state) {
+    Container container;
+    std::vector<size_t> keys((size_t)state.range());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        container.emplace(i, i);
+        keys[i] = i;
+    }
+
+    std::vector<typename Container::iterator> results;
+    for (auto _ : state) {
+        results.clear();
+        container.find_batch(keys.begin(), keys.end(), std::back_inserter(results));
+        benchmark::DoNotOptimize(results);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range());
+}
+
 template< typename Container > static void container_operator_array(benchmark::State& state) {
     Container container;
     for (size_t i = 0; i < (size_t)state.range(); ++i) {
@@ -55,11 +76,88 @@ template< typename Container > static void container_operator_array(benchmark::S
     state.SetItemsProcessed(state.iterations() * state.range());
 }
 
+// Eviction-policy comparison: a fixed-capacity cache fed from realistic key
+// distributions, counting both throughput and the achieved hit ratio. The
+// range is the cache capacity, the keyspace stays fixed, so the policies can
+// be compared at several capacity/keyspace ratios.
+static constexpr size_t keyspace = 1 << 17;
+
+// Zipfian(0.99) keys sampled by binary search in a precomputed CDF.
+static std::vector<double> zipf_cdf;
+
+static void zipf_setup(const benchmark::State&) {
+    if (zipf_cdf.empty()) {
+        zipf_cdf.reserve(keyspace);
+        double sum = 0;
+        for (size_t i = 1; i <= keyspace; ++i)
+            sum += 1.0 / std::pow(double(i), 0.99);
+        double acc = 0;
+        for (size_t i = 1; i <= keyspace; ++i) {
+            acc += 1.0 / std::pow(double(i), 0.99);
+            zipf_cdf.push_back(acc / sum);
+        }
+    }
+}
+
+struct zipfian_keys {
+    size_t x = 12345;
+    size_t operator()() {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        double u = double(x >> 11) * 0x1.0p-53;
+        return std::lower_bound(zipf_cdf.begin(), zipf_cdf.end(), u) - zipf_cdf.begin();
+    }
+};
+
+// Sequential loop over the keyspace, the classic LRU-pathological scan.
+struct scan_keys {
+    size_t n = 0;
+    size_t operator()() { return n++ % keyspace; }
+};
+
+template< typename Cache, typename Keys > static void cache_policy(benchmark::State& state) {
+    containers::evictable_unordered_map< size_t, size_t, std::hash<size_t>, std::equal_to<size_t>,
+        containers::detail::pool_allocator< std::pair<const size_t, size_t> >, Cache > cache;
+    cache.set_capacity((size_t)state.range());
+
+    Keys keys;
+    size_t hits = 0, total = 0;
+    for (auto _ : state) {
+        size_t key = keys();
+        if (cache.find(key) != cache.end())
+            ++hits;
+        else
+            cache.emplace(key, key); // evicts inline through evictable()/erase
+        ++total;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["hit_ratio"] = double(hits) / total;
+}
+
+using cache_value = std::pair<const size_t, size_t>;
+
+BENCHMARK_TEMPLATE(cache_policy, containers::detail::lru_cache<cache_value>, zipfian_keys)->Setup(zipf_setup)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(cache_policy, containers::detail::lru_segmented_cache<cache_value>, zipfian_keys)->Setup(zipf_setup)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(cache_policy, containers::detail::clock_cache<cache_value>, zipfian_keys)->Setup(zipf_setup)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(cache_policy, containers::detail::sampled_lru_cache<cache_value>, zipfian_keys)->Setup(zipf_setup)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(cache_policy, containers::detail::compact_lru_cache<cache_value>, zipfian_keys)->Setup(zipf_setup)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(cache_policy, containers::detail::compact_lru_segmented_cache<cache_value>, zipfian_keys)->Setup(zipf_setup)->Range(1 << 10, 1 << 16);
+
+BENCHMARK_TEMPLATE(cache_policy, containers::detail::lru_cache<cache_value>, scan_keys)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(cache_policy, containers::detail::lru_segmented_cache<cache_value>, scan_keys)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(cache_policy, containers::detail::clock_cache<cache_value>, scan_keys)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(cache_policy, containers::detail::sampled_lru_cache<cache_value>, scan_keys)->Range(1 << 10, 1 << 16);
+
 BENCHMARK_TEMPLATE(container_emplace, std::unordered_map< size_t, size_t >)->Range(1, N);
 BENCHMARK_TEMPLATE(container_emplace, containers::evictable_unordered_map< size_t, size_t >)->Range(1, N);
 
 BENCHMARK_TEMPLATE(container_find, std::unordered_map< size_t, size_t >)->Range(1, N);
 BENCHMARK_TEMPLATE(container_find, containers::evictable_unordered_map< size_t, size_t >)->Range(1, N);
 
+BENCHMARK_TEMPLATE(container_find_batch, containers::evictable_unordered_map< size_t, size_t >)->Range(1, N);
+BENCHMARK_TEMPLATE(container_find_batch, containers::evictable_unordered_map< size_t, size_t, std::hash<size_t>, std::equal_to<size_t>,
+    containers::detail::pool_allocator< std::pair<const size_t, size_t> >,
+    containers::detail::lru_cache< std::pair<const size_t, size_t> >,
+    containers::open_addressing_values >)->Range(1, N);
+
 BENCHMARK_TEMPLATE(container_operator_array, std::unordered_map< size_t, size_t >)->Range(1, N);
 BENCHMARK_TEMPLATE(container_operator_array, containers::evictable_unordered_map< size_t, size_t >)->Range(1, N);
@@ -13,6 +13,7 @@
 
 #include <benchmark/benchmark.h>
 #include <deque>
+#include <shared_mutex>
 #include <vector>
 #include <thread>
 
@@ -43,6 +44,52 @@ template< typename Container > static void container_push_back(benchmark::State&
     state.SetItemsProcessed(state.iterations() * state.range());
 }
 
+static void growable_array_push_back_reserved(benchmark::State& state) {
+    for (auto _ : state) {
+        containers::growable_array<size_t> container((size_t)state.range());
+        for (size_t i = 0; i < (size_t)state.range(); ++i)
+            container.emplace_back(i);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range());
+}
+
+template< typename Container > static void container_append(benchmark::State& state) {
+    std::vector<typename Container::value_type> batch(1024);
+    for (auto _ : state) {
+        Container container;
+        for (size_t i = 0; i < (size_t)state.range(); i += batch.size())
+            container.append(batch.data(), batch.data() + batch.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range());
+}
+
+static void growable_array_scan_indexed(benchmark::State& state) {
+    containers::growable_array<size_t> container;
+    for (size_t i = 0; i < (size_t)state.range(); ++i)
+        container.emplace_back(i);
+    size_t result = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < (size_t)state.range(); ++i)
+            result += container[i];
+    }
+    benchmark::DoNotOptimize(result);
+    state.SetItemsProcessed(state.iterations() * state.range());
+}
+
+static void growable_array_scan_blocks(benchmark::State& state) {
+    containers::growable_array<size_t> container;
+    for (size_t i = 0; i < (size_t)state.range(); ++i)
+        container.emplace_back(i);
+    size_t result = 0;
+    for (auto _ : state) {
+        for (auto span : container.blocks())
+            for (auto value : span)
+                result += value;
+    }
+    benchmark::DoNotOptimize(result);
+    state.SetItemsProcessed(state.iterations() * state.range());
+}
+
 template< typename Container > static void container_indexed_access(benchmark::State& state) {
     Container container;
     container.push_back(typename Container::value_type{});
@@ -84,6 +131,96 @@ template< typename Container > static void container_indexed_access_locked(bench
 }
 
 
+// Thread 0 appends, the remaining threads stream the tail through
+// read(reader_state&, n).
+static containers::growable_array<size_t> tail_array;
+
+static void growable_array_tail_readers(benchmark::State& state) {
+    decltype(tail_array)::reader_state reader;
+    size_t result = 0;
+    if (state.thread_index() == 0) {
+        for (auto _ : state)
+            tail_array.emplace_back(size_t(1));
+    } else {
+        for (auto _ : state) {
+            size_t size = tail_array.size();
+            if (size)
+                result += consume(tail_array.read(reader, size - 1));
+        }
+    }
+    benchmark::DoNotOptimize(result);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static std::deque<size_t> tail_deque;
+static std::shared_mutex tail_deque_mutex;
+
+static void deque_shared_mutex_tail_readers(benchmark::State& state) {
+    size_t result = 0;
+    if (state.thread_index() == 0) {
+        for (auto _ : state) {
+            std::unique_lock lock(tail_deque_mutex);
+            tail_deque.push_back(1);
+        }
+    } else {
+        for (auto _ : state) {
+            std::shared_lock lock(tail_deque_mutex);
+            if (!tail_deque.empty())
+                result += consume(tail_deque.back());
+        }
+    }
+    benchmark::DoNotOptimize(result);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// All threads read random indices across a large array, so the block-map
+// indirection actually misses cache.
+#define RANDOM_N 1ull << 20
+
+static containers::growable_array<size_t> random_array;
+static std::deque<size_t> random_deque;
+static std::shared_mutex random_deque_mutex;
+
+static void random_readers_setup(const benchmark::State&) {
+    if (random_array.empty()) {
+        for (size_t i = 0; i < (RANDOM_N); ++i) {
+            random_array.emplace_back(i);
+            random_deque.push_back(i);
+        }
+    }
+}
+
+static size_t next_index(size_t& x) {
+    x = x * 6364136223846793005ull + 1442695040888963407ull;
+    return (x >> 33) & ((RANDOM_N) - 1);
+}
+
+static void growable_array_random_readers(benchmark::State& state) {
+    decltype(random_array)::reader_state reader;
+    size_t x = state.thread_index() + 1;
+    size_t result = 0;
+    for (auto _ : state)
+        result += consume(random_array.read(reader, next_index(x)));
+    benchmark::DoNotOptimize(result);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void deque_shared_mutex_random_readers(benchmark::State& state) {
+    size_t x = state.thread_index() + 1;
+    size_t result = 0;
+    for (auto _ : state) {
+        std::shared_lock lock(random_deque_mutex);
+        result += consume(random_deque[next_index(x)]);
+    }
+    benchmark::DoNotOptimize(result);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(growable_array_tail_readers)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK(deque_shared_mutex_tail_readers)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK(growable_array_random_readers)->Setup(random_readers_setup)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(deque_shared_mutex_random_readers)->Setup(random_readers_setup)->ThreadRange(1, 16)->UseRealTime();
+
 BENCHMARK_TEMPLATE(container_push_back_locked, std::vector<size_t>)->Range(1, N);
 //BENCHMARK_TEMPLATE(container_push_back_locked, std::vector<std::string>)->Range(1, N);
 
@@ -91,6 +228,9 @@ BENCHMARK_TEMPLATE(container_push_back_locked, std::deque<size_t>)->Range(1, N);
 //BENCHMARK_TEMPLATE(container_push_back_locked, std::deque<std::string>)->Range(1, N);
 
 BENCHMARK_TEMPLATE(container_push_back, containers::growable_array<size_t>)->Range(1, N);
+BENCHMARK(growable_array_push_back_reserved)->Range(1, N);
+BENCHMARK_TEMPLATE(container_push_back, containers::geometric_growable_array<size_t>)->Range(1, N);
+BENCHMARK_TEMPLATE(container_indexed_access, containers::geometric_growable_array<size_t>)->Range(1, N);
 //BENCHMARK_TEMPLATE(container_push_back, containers::growable_array<std::string>)->Range(1, N);
 
 #if !defined(_WIN32)
@@ -98,6 +238,11 @@ BENCHMARK_TEMPLATE(container_push_back, containers::mmapped_array<size_t>)->Rang
 #endif
 //BENCHMARK_TEMPLATE(container_push_back, containers::mmapped_array<std::string>)->Range(1, N);
 
+BENCHMARK_TEMPLATE(container_append, containers::growable_array<size_t>)->Range(1024, N);
+
+BENCHMARK(growable_array_scan_indexed)->Range(1024, N);
+BENCHMARK(growable_array_scan_blocks)->Range(1024, N);
+
 BENCHMARK_TEMPLATE(container_indexed_access, containers::growable_array<size_t>)->Range(1, N);
 
 #if !defined(_WIN32)
@@ -0,0 +1,71 @@
+//
+// This file is part of containers project <https://github.com/romanpauk/containers>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <containers/ring_buffer.h>
+
+#include <benchmark/benchmark.h>
+
+#if __has_include(<concurrentqueue.h>)
+#include <concurrentqueue.h>
+#define HAVE_CONCURRENTQUEUE 1
+#endif
+
+// Thread 0 consumes, the remaining threads produce.
+static containers::ring_buffer<size_t, 1 << 16> spsc_buffer;
+
+static void ring_buffer_spsc(benchmark::State& state) {
+    size_t result = 0;
+    if (state.thread_index() == 0) {
+        for (auto _ : state)
+            spsc_buffer.consume([&](size_t value) { result += value; });
+    } else {
+        for (auto _ : state)
+            while (!spsc_buffer.push(size_t(1)));
+    }
+    benchmark::DoNotOptimize(result);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static containers::mpsc_ring_buffer<size_t, 1 << 16> mpsc_buffer;
+
+static void mpsc_ring_buffer_producers(benchmark::State& state) {
+    size_t result = 0;
+    if (state.thread_index() == 0) {
+        for (auto _ : state)
+            mpsc_buffer.consume([&](size_t value) { result += value; });
+    } else {
+        for (auto _ : state)
+            while (!mpsc_buffer.push(size_t(1)));
+    }
+    benchmark::DoNotOptimize(result);
+    state.SetItemsProcessed(state.iterations());
+}
+
+#if defined(HAVE_CONCURRENTQUEUE)
+static moodycamel::ConcurrentQueue<size_t> concurrent_queue;
+
+static void concurrentqueue_producers(benchmark::State& state) {
+    size_t result = 0;
+    if (state.thread_index() == 0) {
+        size_t value;
+        for (auto _ : state)
+            while (concurrent_queue.try_dequeue(value))
+                result += value;
+    } else {
+        for (auto _ : state)
+            concurrent_queue.enqueue(size_t(1));
+    }
+    benchmark::DoNotOptimize(result);
+    state.SetItemsProcessed(state.iterations());
+}
+#endif
+
+BENCHMARK(ring_buffer_spsc)->Threads(2)->UseRealTime();
+BENCHMARK(mpsc_ring_buffer_producers)->ThreadRange(2, 16)->UseRealTime();
+#if defined(HAVE_CONCURRENTQUEUE)
+BENCHMARK(concurrentqueue_producers)->ThreadRange(2, 16)->UseRealTime();
+#endif
@@ -0,0 +1,94 @@
+//
+// This file is part of containers project <https://github.com/romanpauk/containers>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace containers::detail {
+    // Bump arena for containers that tear down wholesale: allocations are
+    // carved from large chunks, deallocate() is a no-op and release() hands
+    // the chunks themselves back upstream, so destroying a container built
+    // on the arena costs a handful of frees instead of one per block or
+    // node. Containers detect release() and skip their per-block walk, see
+    // growable_array::clear.
+    template<
+        typename T,
+        typename Allocator = std::allocator<T>,
+        size_t ChunkSize = 1 << 20,
+        typename AllocatorBase = typename std::allocator_traits<Allocator>::template rebind_alloc<uint8_t>
+    > class arena_allocator: public AllocatorBase {
+        uint8_t* chunk_ = nullptr;
+        size_t remaining_ = 0;
+        std::vector<std::pair<uint8_t*, size_t>> chunks_;
+
+    public:
+        // The base class is an allocator of bytes, its member types must not
+        // leak through to allocator_traits.
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        template< typename U > struct rebind {
+            using other = arena_allocator<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>, ChunkSize>;
+        };
+
+        arena_allocator() = default;
+        arena_allocator(const Allocator& alloc): AllocatorBase(alloc) {}
+        // Arenas are not shared, a copy starts empty.
+        arena_allocator(const arena_allocator&): arena_allocator() {}
+        template< typename U, typename AllocatorU > arena_allocator(const arena_allocator<U, AllocatorU, ChunkSize>&): arena_allocator() {}
+        arena_allocator& operator = (const arena_allocator&) = delete;
+
+        arena_allocator(arena_allocator&& other):
+            chunk_(other.chunk_), remaining_(other.remaining_), chunks_(std::move(other.chunks_)) {
+            other.chunk_ = nullptr;
+            other.remaining_ = 0;
+        }
+
+        ~arena_allocator() {
+            release();
+        }
+
+        T* allocate(size_t n) {
+            size_t bytes = (sizeof(T) * n + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+            if (bytes > remaining_) {
+                size_t size = std::max(bytes, ChunkSize);
+                chunk_ = AllocatorBase::allocate(size);
+                chunks_.emplace_back(chunk_, size);
+                remaining_ = size;
+            }
+            T* ptr = (T*)chunk_;
+            chunk_ += bytes;
+            remaining_ -= bytes;
+            return ptr;
+        }
+
+        // Individual frees are dropped, the memory comes back at release().
+        void deallocate(T*, size_t) {}
+
+        // The deferred reclamation interface, so the arena can also stand in
+        // where a deferred_allocator is expected.
+        void reclaim(T*, size_t) {}
+        void reset() { release(); }
+
+        void release() {
+            for (auto& chunk: chunks_)
+                AllocatorBase::deallocate(chunk.first, chunk.second);
+            chunks_.clear();
+            chunk_ = nullptr;
+            remaining_ = 0;
+        }
+
+        friend bool operator == (const arena_allocator&, const arena_allocator&) { return true; }
+        friend bool operator != (const arena_allocator&, const arena_allocator&) { return false; }
+    };
+}
@@ -51,6 +51,9 @@ namespace containers::detail {
     public:
         using value_type = T;
 
+        deferred_allocator() = default;
+        deferred_allocator(const Allocator& alloc): AllocatorBase(alloc) {}
+
         ~deferred_allocator() {
             reset();
         }
@@ -0,0 +1,144 @@
+//
+// This file is part of containers project <https://github.com/romanpauk/containers>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+
+namespace containers::detail {
+    // Deferred reclamation bounded by reader quiescence (QSBR). Readers
+    // register a slot and announce the global epoch before each read,
+    // reclaimed buffers are stamped with the epoch at retirement and freed
+    // once every active reader has announced a later epoch. A registered
+    // reader that stops announcing holds back reclamation until its slot is
+    // released.
+    template<
+        typename T,
+        typename Allocator,
+        typename AllocatorBase = typename std::allocator_traits<Allocator>::template rebind_alloc<uint8_t>
+    > class epoch_allocator: public AllocatorBase {
+        struct alignas(16) buffer {
+            buffer* next = nullptr;
+            size_t size = 0;
+            uint64_t epoch = 0;
+        };
+
+        buffer* buffer_cast(T* ptr) {
+            return reinterpret_cast<buffer*>(reinterpret_cast<uintptr_t>(ptr) - sizeof(buffer));
+        }
+
+    public:
+        struct reader {
+            std::atomic<uint64_t> epoch{0};
+            std::atomic<bool> active{false};
+            reader* next = nullptr;
+
+            void release() { active.store(false, std::memory_order_release); }
+        };
+
+        using value_type = T;
+
+        ~epoch_allocator() {
+            reset();
+            while (readers_) {
+                reader* r = readers_;
+                readers_ = r->next;
+                delete r;
+            }
+        }
+
+        T* allocate(size_t n) {
+            static_assert(sizeof(buffer) == 32);
+            buffer* ptr = (buffer*)AllocatorBase::allocate(sizeof(buffer) + sizeof(T) * n);
+            new (ptr) buffer();
+            ptr->size = sizeof(buffer) + sizeof(T) * n;
+            return reinterpret_cast<T*>(ptr + 1);
+        }
+
+        // Retires the buffer under the current epoch and advances the epoch,
+        // freeing earlier retirements every reader has already passed.
+        void reclaim(T* ptr, size_t) {
+            buffer* b = buffer_cast(ptr);
+            b->epoch = epoch_.load(std::memory_order_relaxed);
+            b->next = retired_;
+            retired_ = b;
+            epoch_.store(b->epoch + 1, std::memory_order_release);
+            collect();
+        }
+
+        // Frees all retirements unconditionally, requires quiescence.
+        void reset() {
+            while (retired_) {
+                buffer* b = retired_;
+                retired_ = b->next;
+                AllocatorBase::deallocate((uint8_t*)b, b->size);
+            }
+        }
+
+        reader* register_reader() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (reader* r = readers_; r; r = r->next) {
+                if (!r->active.load(std::memory_order_acquire)) {
+                    r->epoch.store(epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    r->active.store(true, std::memory_order_release);
+                    return r;
+                }
+            }
+            reader* r = new reader;
+            r->epoch.store(epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            r->active.store(true, std::memory_order_relaxed);
+            r->next = readers_;
+            readers_ = r;
+            return r;
+        }
+
+        // The acquire load pairs with the release store in reclaim(): a reader
+        // announcing epoch e cannot subsequently observe state retired before
+        // the epoch advanced to e. The release store pairs with the acquire
+        // load in collect(), ordering the reader's preceding accesses of
+        // retired state before the writer frees it.
+        void announce(reader& r) {
+            r.epoch.store(epoch_.load(std::memory_order_acquire), std::memory_order_release);
+        }
+
+        size_t retired() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t count = 0;
+            for (buffer* b = retired_; b; b = b->next)
+                ++count;
+            return count;
+        }
+
+    private:
+        void collect() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            uint64_t min = epoch_.load(std::memory_order_relaxed);
+            for (reader* r = readers_; r; r = r->next) {
+                if (r->active.load(std::memory_order_acquire))
+                    min = std::min(min, r->epoch.load(std::memory_order_acquire));
+            }
+            buffer** b = &retired_;
+            while (*b) {
+                if ((*b)->epoch < min) {
+                    buffer* dead = *b;
+                    *b = dead->next;
+                    AllocatorBase::deallocate((uint8_t*)dead, dead->size);
+                } else {
+                    b = &(*b)->next;
+                }
+            }
+        }
+
+        std::atomic<uint64_t> epoch_{1};
+        buffer* retired_ = nullptr;
+        reader* readers_ = nullptr;
+        std::mutex mutex_;
+    };
+}
@@ -0,0 +1,75 @@
+//
+// This file is part of containers project <https://github.com/romanpauk/containers>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace containers::detail {
+#if defined(__linux__)
+    // Memory policy modes from linux/mempolicy.h.
+    enum class numa_mode { first_touch = 0, bind = 2, interleave = 3 };
+
+    // Thin mbind wrapper. Placement is advisory: failures (nodes missing
+    // from the cpuset, CONFIG_NUMA off) silently fall back to first touch,
+    // so NUMA-configured containers still run on single-node machines.
+    inline void mbind_pages(void* ptr, size_t size, numa_mode mode, unsigned long nodemask) {
+    #if defined(SYS_mbind)
+        syscall(SYS_mbind, ptr, size, static_cast<int>(mode), &nodemask, sizeof(nodemask) * 8, 0);
+    #else
+        (void)ptr; (void)size; (void)mode; (void)nodemask;
+    #endif
+    }
+
+    // Page-backed allocator with a NUMA placement mode, meant as the
+    // BlockAllocator of a growable_array whose readers are pinned away from
+    // the writer: interleave spreads the blocks across the nodemask, bind
+    // places them all on one node, first_touch leaves placement to the
+    // first writing thread. Allocations are rounded up to whole pages, so
+    // it only pays off with block sizes near a page or above.
+    template< typename T > class numa_allocator {
+        template< typename U > friend class numa_allocator;
+
+        numa_mode mode_ = numa_mode::first_touch;
+        unsigned long nodemask_ = 0;
+
+        static size_t bytes(size_t n) { return (sizeof(T) * n + 4095) & ~size_t(4095); }
+
+    public:
+        using value_type = T;
+
+        numa_allocator() = default;
+        numa_allocator(numa_mode mode, unsigned long nodemask = 1): mode_(mode), nodemask_(nodemask) {}
+        template< typename U > numa_allocator(const numa_allocator<U>& other):
+            mode_(other.mode_), nodemask_(other.nodemask_) {}
+
+        T* allocate(size_t n) {
+            void* ptr = mmap(0, bytes(n), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if ((uintptr_t)ptr == (uintptr_t)-1)
+                std::abort();
+            if (mode_ != numa_mode::first_touch)
+                mbind_pages(ptr, bytes(n), mode_, nodemask_);
+            return reinterpret_cast<T*>(ptr);
+        }
+
+        void deallocate(T* ptr, size_t n) { munmap(ptr, bytes(n)); }
+
+        friend bool operator == (const numa_allocator& lhs, const numa_allocator& rhs) {
+            return lhs.mode_ == rhs.mode_ && lhs.nodemask_ == rhs.nodemask_;
+        }
+        friend bool operator != (const numa_allocator& lhs, const numa_allocator& rhs) { return !(lhs == rhs); }
+    };
+#endif
+}
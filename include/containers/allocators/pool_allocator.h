@@ -0,0 +1,102 @@
+//
+// This file is part of containers project <https://github.com/romanpauk/containers>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace containers::detail {
+    // Freelist pool for same-sized node churn: deallocated single elements go
+    // to a freelist and are handed back on the next allocate(1), fresh
+    // elements are carved from chunks refilled from the upstream allocator,
+    // so steady-state allocate/deallocate cycles make no heap calls. Array
+    // allocations pass through to the upstream allocator untouched.
+    template<
+        typename T,
+        typename Allocator = std::allocator<T>,
+        size_t ChunkSize = 1024
+    > class pool_allocator: public std::allocator_traits<Allocator>::template rebind_alloc<uint8_t> {
+        using base = typename std::allocator_traits<Allocator>::template rebind_alloc<uint8_t>;
+        template< typename U, typename AllocatorU, size_t > friend class pool_allocator;
+
+        struct free_node { free_node* next; };
+        static constexpr size_t slot_size = sizeof(T) < sizeof(free_node) ? sizeof(free_node) : sizeof(T);
+
+        free_node* free_ = nullptr;
+        uint8_t* chunk_ = nullptr;
+        size_t remaining_ = 0;
+        std::vector<uint8_t*> chunks_;
+
+    public:
+        // The base class is an allocator of bytes, its member types must not
+        // leak through to allocator_traits.
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        template< typename U > struct rebind {
+            using other = pool_allocator<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>, ChunkSize>;
+        };
+
+        pool_allocator() = default;
+        // Pools are not shared, a copy starts empty.
+        pool_allocator(const pool_allocator&): pool_allocator() {}
+        template< typename U, typename AllocatorU > pool_allocator(const pool_allocator<U, AllocatorU, ChunkSize>&): pool_allocator() {}
+        pool_allocator& operator = (const pool_allocator&) = delete;
+
+        pool_allocator(pool_allocator&& other):
+            free_(other.free_), chunk_(other.chunk_), remaining_(other.remaining_), chunks_(std::move(other.chunks_)) {
+            other.free_ = nullptr;
+            other.chunk_ = nullptr;
+            other.remaining_ = 0;
+        }
+
+        ~pool_allocator() {
+            for (auto chunk: chunks_)
+                base::deallocate(chunk, slot_size * ChunkSize);
+        }
+
+        T* allocate(size_t n) {
+            if (n != 1)
+                return (T*)base::allocate(sizeof(T) * n);
+            if (free_) {
+                free_node* f = free_;
+                free_ = f->next;
+                return (T*)f;
+            }
+            if (!remaining_) {
+                chunk_ = base::allocate(slot_size * ChunkSize);
+                chunks_.push_back(chunk_);
+                remaining_ = ChunkSize;
+            }
+            --remaining_;
+            T* ptr = (T*)chunk_;
+            chunk_ += slot_size;
+            return ptr;
+        }
+
+        void deallocate(T* ptr, size_t n) {
+            if (n != 1) {
+                base::deallocate((uint8_t*)ptr, sizeof(T) * n);
+                return;
+            }
+            free_node* f = (free_node*)ptr;
+            f->next = free_;
+            free_ = f;
+        }
+
+        // Pools are distinct: a node carved from one pool's chunk must never
+        // land on another pool's freelist, it dangles once the owning pool
+        // frees its chunks. Only identity makes cross-instance deallocation
+        // valid.
+        friend bool operator == (const pool_allocator& lhs, const pool_allocator& rhs) { return &lhs == &rhs; }
+        friend bool operator != (const pool_allocator& lhs, const pool_allocator& rhs) { return &lhs != &rhs; }
+    };
+}
@@ -5,10 +5,24 @@
 // SPDX-License-Identifier: MIT
 //
 
+#include <containers/allocators/pool_allocator.h>
+#include <containers/stats.h>
+
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
 #include <unordered_set>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace containers {
     namespace detail {
@@ -61,6 +75,7 @@ namespace containers {
                 if (!tail_) {
                     assert(!head_);
                     tail_ = head_ = &n;
+                    n.prev = n.next = nullptr;
                 } else {
                     n.next = nullptr;
                     n.prev = tail_;
@@ -138,6 +153,8 @@ namespace containers {
                 list_.push_front(n);
             }
 
+            void clear() { list_.clear(); }
+
         private:
             linked_list<node> list_;
         };
@@ -180,15 +197,669 @@ namespace containers {
                 segments_[1].push_front(n);
             }
 
+            void clear() {
+                segments_[0].clear();
+                segments_[1].clear();
+            }
+
         private:
             linked_list<node> segments_[2];
         };
 
-    #if __cpp_lib_generic_unordered_lookup != 201811L
+        // LRU with 32-bit index links: a node carries one 4-byte slot id
+        // instead of two 8-byte pointers, and all links live in one dense
+        // array (eight per cache line), so touch()-heavy workloads relink
+        // inside the link array instead of dirtying the value nodes spread
+        // across the table. The top bit of the slot id is spare; the
+        // segmented variant below encodes its segment there.
+        template< typename Node > struct node_iterator {
+            node_iterator(const Node* n): node_(n) {}
+
+            const typename Node::value_type& operator*() { assert(node_); return node_->value; }
+            const typename Node::value_type* operator->() { assert(node_); return &node_->value; }
+
+            bool operator == (const node_iterator& other) const { return node_ == other.node_; }
+            bool operator != (const node_iterator& other) const { return node_ != other.node_; }
+
+            const Node* node_;
+        };
+
+        template< typename T > struct compact_lru_cache {
+            static constexpr uint32_t invalid = 0xffffffff;
+
+            struct node {
+                using value_type = T;
+                value_type value;
+                mutable uint32_t slot_ = invalid;
+            };
+
+            using iterator = node_iterator<node>;
+
+            iterator evictable() const {
+                return tail_ == invalid ? nullptr : nodes_[tail_];
+            }
+
+            iterator end() const { return iterator(nullptr); }
+
+            void erase(const node& n) {
+                unlink(n.slot_);
+                links_[n.slot_].next = free_;
+                free_ = n.slot_;
+                nodes_[n.slot_] = nullptr;
+            }
+
+            void emplace(const node& n, bool inserted) {
+                if (inserted) {
+                    n.slot_ = acquire_slot(&n);
+                    push_front(n.slot_);
+                } else if (head_ != n.slot_) {
+                    unlink(n.slot_);
+                    push_front(n.slot_);
+                }
+            }
+
+            void touch(const node& n) {
+                if (head_ != n.slot_) {
+                    unlink(n.slot_);
+                    push_front(n.slot_);
+                }
+            }
+
+            void clear() {
+                links_.clear();
+                nodes_.clear();
+                head_ = tail_ = free_ = invalid;
+            }
+
+        protected:
+            struct link {
+                uint32_t next = invalid;
+                uint32_t prev = invalid;
+            };
+
+            uint32_t acquire_slot(const node* n) {
+                uint32_t id;
+                if (free_ != invalid) {
+                    id = free_;
+                    free_ = links_[id].next;
+                } else {
+                    assert(links_.size() < invalid);
+                    id = (uint32_t)links_.size();
+                    links_.push_back({});
+                    nodes_.push_back(nullptr);
+                }
+                nodes_[id] = n;
+                return id;
+            }
+
+            void push_front(uint32_t id) {
+                links_[id] = {head_, invalid};
+                if (head_ != invalid)
+                    links_[head_].prev = id;
+                else
+                    tail_ = id;
+                head_ = id;
+            }
+
+            void unlink(uint32_t id) {
+                auto& l = links_[id];
+                if (l.next != invalid)
+                    links_[l.next].prev = l.prev;
+                else
+                    tail_ = l.prev;
+                if (l.prev != invalid)
+                    links_[l.prev].next = l.next;
+                else
+                    head_ = l.next;
+            }
+
+            mutable std::vector<link> links_;
+            mutable std::vector<const node*> nodes_;
+            mutable uint32_t head_ = invalid;
+            mutable uint32_t tail_ = invalid;
+            mutable uint32_t free_ = invalid;
+        };
+
+        // Segmented variant of compact_lru_cache: probation and protected
+        // segments share the dense link array and the segment is encoded in
+        // the top bit of the slot id, so promotion on touch() is still a few
+        // stores into 8-byte link records.
+        template< typename T > struct compact_lru_segmented_cache {
+            static constexpr uint32_t invalid = 0xffffffff;
+            static constexpr uint32_t segment_bit = 0x80000000;
+
+            struct node {
+                using value_type = T;
+                value_type value;
+                mutable uint32_t slot_ = invalid;
+            };
+
+            using iterator = node_iterator<node>;
+
+            iterator evictable() const {
+                if (tail_[0] != invalid)
+                    return nodes_[tail_[0]];
+                return tail_[1] == invalid ? nullptr : nodes_[tail_[1]];
+            }
+
+            iterator end() const { return iterator(nullptr); }
+
+            void erase(const node& n) {
+                uint32_t id = n.slot_ & ~segment_bit;
+                unlink(id, n.slot_ >> 31);
+                links_[id].next = free_;
+                free_ = id;
+                nodes_[id] = nullptr;
+            }
+
+            void emplace(const node& n, bool inserted) {
+                if (inserted) {
+                    n.slot_ = acquire_slot(&n); // probation, segment bit clear
+                    push_front(n.slot_, 0);
+                } else {
+                    promote(n);
+                }
+            }
+
+            void touch(const node& n) { promote(n); }
+
+            void clear() {
+                links_.clear();
+                nodes_.clear();
+                head_[0] = head_[1] = tail_[0] = tail_[1] = free_ = invalid;
+            }
+
+        private:
+            struct link {
+                uint32_t next = invalid;
+                uint32_t prev = invalid;
+            };
+
+            void promote(const node& n) {
+                uint32_t id = n.slot_ & ~segment_bit;
+                unlink(id, n.slot_ >> 31);
+                n.slot_ = id | segment_bit;
+                push_front(id, 1);
+            }
+
+            uint32_t acquire_slot(const node* n) {
+                uint32_t id;
+                if (free_ != invalid) {
+                    id = free_;
+                    free_ = links_[id].next;
+                } else {
+                    assert(links_.size() < segment_bit);
+                    id = (uint32_t)links_.size();
+                    links_.push_back({});
+                    nodes_.push_back(nullptr);
+                }
+                nodes_[id] = n;
+                return id;
+            }
+
+            void push_front(uint32_t id, size_t segment) {
+                links_[id] = {head_[segment], invalid};
+                if (head_[segment] != invalid)
+                    links_[head_[segment]].prev = id;
+                else
+                    tail_[segment] = id;
+                head_[segment] = id;
+            }
+
+            void unlink(uint32_t id, size_t segment) {
+                auto& l = links_[id];
+                if (l.next != invalid)
+                    links_[l.next].prev = l.prev;
+                else
+                    tail_[segment] = l.prev;
+                if (l.prev != invalid)
+                    links_[l.prev].next = l.next;
+                else
+                    head_[segment] = l.next;
+            }
+
+            mutable std::vector<link> links_;
+            mutable std::vector<const node*> nodes_;
+            mutable uint32_t head_[2] = {invalid, invalid};
+            mutable uint32_t tail_[2] = {invalid, invalid};
+            mutable uint32_t free_ = invalid;
+        };
+
+        // CLOCK policy: touch() only sets a reference bit instead of
+        // relinking the node, evictable() sweeps a hand that clears the bits,
+        // giving each referenced node a second chance.
+        template< typename T > struct clock_cache {
+            struct node {
+                using value_type = T;
+                value_type value;
+                mutable bool referenced = false;
+                mutable const node* next = nullptr;
+                mutable const node* prev = nullptr;
+            };
+
+            using iterator = typename linked_list<node>::iterator;
+
+            iterator evictable() const {
+                const node* hand = hand_ ? hand_ : list_.head();
+                if (!hand)
+                    return end();
+                while (hand->referenced) {
+                    hand->referenced = false;
+                    hand = hand->next ? hand->next : list_.head();
+                }
+                hand_ = hand;
+                return hand;
+            }
+
+            iterator end() const { return typename linked_list<node>::iterator(nullptr); }
+
+            void erase(const node& n) {
+                if (hand_ == &n)
+                    hand_ = n.next;
+                list_.erase(n);
+            }
+
+            void emplace(const node& n, bool inserted) {
+                if (inserted) {
+                    list_.push_back(n);
+                } else {
+                    n.referenced = true;
+                }
+            }
+
+            void touch(const node& n) {
+                n.referenced = true;
+            }
+
+            void clear() {
+                list_.clear();
+                hand_ = nullptr;
+            }
+
+        private:
+            linked_list<node> list_;
+            mutable const node* hand_ = nullptr;
+        };
+
+        // Time-aware policy: nodes are kept ordered by deadline, emplace()
+        // and touch() stamp now + ttl and move the node to the back, so the
+        // head is always the entry expiring first. expire(now) unlinks all
+        // expired nodes in O(expired) and hands them back as a batch.
+        template< typename T, typename Clock = std::chrono::steady_clock > struct ttl_cache {
+            using clock = Clock;
+            using time_point = typename Clock::time_point;
+            using duration = typename Clock::duration;
+
+            struct node {
+                using value_type = T;
+                value_type value;
+                mutable time_point deadline = {};
+                mutable const node* next = nullptr;
+                mutable const node* prev = nullptr;
+            };
+
+            using iterator = typename linked_list<node>::iterator;
+
+            void set_ttl(duration ttl) { ttl_ = ttl; }
+
+            iterator evictable() const {
+                return list_.head();
+            }
+
+            iterator end() const { return typename linked_list<node>::iterator(nullptr); }
+
+            void erase(const node& n) { list_.erase(n); }
+
+            void emplace(const node& n, bool inserted) {
+                n.deadline = deadline();
+                if (!inserted)
+                    list_.erase(n);
+                list_.push_back(n);
+            }
+
+            void touch(const node& n) {
+                n.deadline = deadline();
+                list_.erase(n);
+                list_.push_back(n);
+            }
+
+            linked_list<node> expire(time_point now) {
+                linked_list<node> batch;
+                while (list_.head() && list_.head()->deadline <= now) {
+                    const node& n = *list_.head();
+                    list_.erase(n);
+                    batch.push_back(n);
+                }
+                return batch;
+            }
+
+            void clear() { list_.clear(); }
+
+        private:
+            time_point deadline() const {
+                return ttl_ == duration::max() ? time_point::max() : Clock::now() + ttl_;
+            }
+
+            linked_list<node> list_;
+            duration ttl_ = duration::max();
+        };
+
+        // LRU variant whose readers never touch the list: record() only
+        // increments a per-node atomic counter, and the writer drains pending
+        // accesses when looking for a victim, moving recorded nodes back to
+        // the front. Pairs with evictable_unordered_map::find_readonly().
+        template< typename T > struct sampled_lru_cache {
+            struct node {
+                using value_type = T;
+                node(value_type v): value(std::move(v)) {}
+                node(node&& other): value(std::move(other.value)) {}
+
+                value_type value;
+                mutable std::atomic<uint32_t> accesses{0};
+                mutable const node* next = nullptr;
+                mutable const node* prev = nullptr;
+            };
+
+            using iterator = typename linked_list<node>::iterator;
+
+            // Drains recorded accesses from the tail; under sustained reader
+            // load the sweep is bounded only by re-recorded nodes.
+            iterator evictable() const {
+                const node* n = list_.tail();
+                while (n && n->accesses.load(std::memory_order_relaxed)) {
+                    n->accesses.store(0, std::memory_order_relaxed);
+                    list_.erase(*n);
+                    list_.push_front(*n);
+                    n = list_.tail();
+                }
+                return n;
+            }
+
+            iterator end() const { return typename linked_list<node>::iterator(nullptr); }
+
+            void erase(const node& n) { list_.erase(n); }
+
+            void emplace(const node& n, bool inserted) {
+                if (inserted) {
+                    list_.push_front(n);
+                } else if (&n != list_.head()) {
+                    list_.erase(n);
+                    list_.push_front(n);
+                }
+            }
+
+            void touch(const node& n) {
+                list_.erase(n);
+                list_.push_front(n);
+            }
+
+            void record(const node& n) const {
+                n.accesses.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void clear() { list_.clear(); }
+
+        private:
+            mutable linked_list<node> list_;
+        };
+
+        // Raw binary serialization for map snapshots: trivially copyable
+        // types are written as-is, strings as length-prefixed bytes.
+        template< typename Stream, typename T > void snapshot_write(Stream& stream, const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template< typename Stream, typename C, typename Tr, typename A > void snapshot_write(Stream& stream, const std::basic_string<C, Tr, A>& value) {
+            uint64_t size = value.size();
+            stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            stream.write(reinterpret_cast<const char*>(value.data()), size * sizeof(C));
+        }
+
+        template< typename Stream, typename T > void snapshot_read(Stream& stream, T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+        }
+
+        template< typename Stream, typename C, typename Tr, typename A > void snapshot_read(Stream& stream, std::basic_string<C, Tr, A>& value) {
+            uint64_t size = 0;
+            stream.read(reinterpret_cast<char*>(&size), sizeof(size));
+            value.resize(size);
+            stream.read(reinterpret_cast<char*>(value.data()), size * sizeof(C));
+        }
+
+        template< typename Cache, typename Node, typename = void > struct cache_has_record: std::false_type {};
+        template< typename Cache, typename Node > struct cache_has_record<Cache, Node,
+            std::void_t<decltype(std::declval<const Cache&>().record(std::declval<const Node&>()))>>: std::true_type {};
+
+        // Open-addressing hash table over nodes kept in a slab of fixed-size
+        // chunks, so node addresses stay stable across rehashing and the
+        // intrusive cache links keep working. The table itself only stores
+        // (hash, node index) pairs, probed linearly.
+        template<
+            typename Node,
+            typename Hash,
+            typename KeyEqual,
+            typename Allocator,
+            size_t ChunkSize = 1024
+        > class open_addressing_node_set: Hash, KeyEqual {
+            static_assert((ChunkSize & (ChunkSize - 1)) == 0);
+
+            static constexpr size_t empty_index = 0;
+            static constexpr size_t tombstone_index = 1;
+
+            struct slot {
+                size_t hash = 0;
+                size_t index = empty_index; // node index + 2, or empty/tombstone
+            };
+
+            using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+
+            // The bookkeeping vectors swap and reallocate freely, so they
+            // stay on std::allocator; only the node chunks come from the
+            // map's allocator, held as one instance so stateful allocators
+            // (pools compare by identity) free what they allocated.
+            node_allocator allocator_;
+            std::vector<Node*> chunks_;
+            std::vector<size_t> free_;
+            std::vector<slot> slots_;
+            size_t size_ = 0;
+            size_t used_ = 0;  // occupied slots, including tombstones
+            size_t nodes_ = 0; // constructed node high-water mark
+
+            template< typename K > size_t hash(const K& key) const { return static_cast<const Hash&>(*this)(key); }
+            template< typename K > bool equal(const K& key, const Node& n) const { return static_cast<const KeyEqual&>(*this)(key, n); }
+
+            Node* node_at(size_t n) const {
+                return chunks_[n / ChunkSize] + (n % ChunkSize);
+            }
+
+            size_t acquire_node() {
+                if (!free_.empty()) {
+                    size_t n = free_.back();
+                    free_.pop_back();
+                    return n;
+                }
+                if (nodes_ == chunks_.size() * ChunkSize)
+                    chunks_.push_back(allocator_.allocate(ChunkSize));
+                return nodes_++;
+            }
+
+            void rehash(size_t capacity) {
+                std::vector<slot> slots(capacity);
+                size_t mask = capacity - 1;
+                for (auto& s: slots_) {
+                    if (s.index < 2)
+                        continue;
+                    size_t i = s.hash & mask;
+                    while (slots[i].index != empty_index)
+                        i = (i + 1) & mask;
+                    slots[i] = s;
+                }
+                slots_.swap(slots);
+                used_ = size_;
+            }
+
+        public:
+            struct iterator {
+                iterator(): set_(nullptr), slot_(size_t(-1)) {}
+                iterator(const open_addressing_node_set* set, size_t n): set_(set), slot_(n) {}
+
+                Node& operator*() const { return *set_->node_at(set_->slots_[slot_].index - 2); }
+                Node* operator->() const { return &operator*(); }
+
+                bool operator == (const iterator& other) const { return slot_ == other.slot_; }
+                bool operator != (const iterator& other) const { return slot_ != other.slot_; }
+
+                iterator& operator++() {
+                    do {
+                        ++slot_;
+                    } while (slot_ < set_->slots_.size() && set_->slots_[slot_].index < 2);
+                    return *this;
+                }
+                iterator operator++(int) { iterator it = *this; operator++(); return it; }
+
+            private:
+                friend class open_addressing_node_set;
+                const open_addressing_node_set* set_;
+                size_t slot_;
+            };
+
+            open_addressing_node_set() = default;
+            open_addressing_node_set(const open_addressing_node_set&) = delete;
+            open_addressing_node_set& operator = (const open_addressing_node_set&) = delete;
+
+            ~open_addressing_node_set() { clear(); }
+
+            iterator begin() const {
+                iterator it(this, 0);
+                if (!slots_.empty() && slots_[0].index < 2)
+                    ++it;
+                return it;
+            }
+
+            iterator end() const { return iterator(this, slots_.size()); }
+
+            // Issues a prefetch of the key's first probe slot. Pairs with
+            // evictable_unordered_map::find_batch, which prefetches a whole
+            // window of slots before probing any of them.
+            template< typename K > void prefetch(const K& key) const {
+                if (!slots_.empty()) {
+            #if defined(_MSC_VER)
+                    _mm_prefetch(reinterpret_cast<const char*>(&slots_[this->hash(key) & (slots_.size() - 1)]), _MM_HINT_T0);
+            #else
+                    __builtin_prefetch(&slots_[this->hash(key) & (slots_.size() - 1)]);
+            #endif
+                }
+            }
+
+            template< typename K > iterator find(const K& key) const {
+                if (!size_)
+                    return end();
+                size_t h = this->hash(key);
+                size_t mask = slots_.size() - 1;
+                size_t i = h & mask;
+                while (true) {
+                    const slot& s = slots_[i];
+                    if (s.index == empty_index)
+                        return end();
+                    if (s.index != tombstone_index && s.hash == h && equal(key, *node_at(s.index - 2)))
+                        return iterator(this, i);
+                    i = (i + 1) & mask;
+                }
+            }
+
+            std::pair<iterator, bool> emplace(Node&& n) {
+                if (slots_.empty())
+                    rehash(16);
+                size_t h = this->hash(n);
+                size_t mask = slots_.size() - 1;
+                size_t i = h & mask;
+                size_t target = slots_.size();
+                while (true) {
+                    slot& s = slots_[i];
+                    if (s.index == empty_index) {
+                        if (target == slots_.size())
+                            target = i;
+                        break;
+                    }
+                    if (s.index == tombstone_index) {
+                        if (target == slots_.size())
+                            target = i;
+                    } else if (s.hash == h && equal(n, *node_at(s.index - 2))) {
+                        return {iterator(this, i), false};
+                    }
+                    i = (i + 1) & mask;
+                }
+
+                if (slots_[target].index == empty_index && (used_ + 1) * 4 > slots_.size() * 3) {
+                    rehash(slots_.size() * 2);
+                    mask = slots_.size() - 1;
+                    target = h & mask;
+                    while (slots_[target].index != empty_index)
+                        target = (target + 1) & mask;
+                }
+
+                size_t index = acquire_node();
+                new (node_at(index)) Node(std::move(n));
+                if (slots_[target].index == empty_index)
+                    ++used_;
+                slots_[target] = {h, index + 2};
+                ++size_;
+                return {iterator(this, target), true};
+            }
+
+            iterator erase(iterator it) {
+                assert(it != end());
+                slot& s = slots_[it.slot_];
+                size_t index = s.index - 2;
+                node_at(index)->~Node();
+                free_.push_back(index);
+                s.index = tombstone_index;
+                --size_;
+                iterator next = it;
+                if (slots_[next.slot_].index < 2)
+                    ++next;
+                return next;
+            }
+
+            void clear() {
+                // Trivially destructible nodes skip the slot walk entirely,
+                // teardown is then one free per chunk.
+                if constexpr (!std::is_trivially_destructible_v<Node>) {
+                    for (auto& s: slots_) {
+                        if (s.index >= 2)
+                            node_at(s.index - 2)->~Node();
+                    }
+                }
+                for (auto chunk: chunks_)
+                    allocator_.deallocate(chunk, ChunkSize);
+                chunks_.clear();
+                free_.clear();
+                slots_.clear();
+                size_ = used_ = nodes_ = 0;
+            }
+
+            float load_factor() const { return slots_.empty() ? 0.f : float(size_) / slots_.size(); }
+
+            // Pre-sizes the slots for n nodes so inserting them rehashes at
+            // most once.
+            void reserve(size_t n) {
+                size_t capacity = 16;
+                while (n * 4 > capacity * 3)
+                    capacity *= 2;
+                if (capacity > slots_.size())
+                    rehash(capacity);
+            }
+
+            size_t size() const { return size_; }
+            bool empty() const { return size_ == 0; }
+        };
+
         template< typename Node, typename Key, bool IsTriviallyDestructible = std::is_trivially_destructible_v<Key> > struct hashable_node;
-        
+
         template< typename Node, typename Key> struct hashable_node<Node, Key, true> {
-            hashable_node(const Key& key) {
+            template< typename K > hashable_node(const K& key) {
                 new (const_cast<Key*>(&node().value.first)) Key(key);
             }
 
@@ -198,12 +869,30 @@ namespace containers {
         };
 
         template< typename Node, typename Key > struct hashable_node<Node, Key, false>
-            : hashable_node<Node, Key, true> 
+            : hashable_node<Node, Key, true>
         {
-            hashable_node(const Key& key): hashable_node<Node, Key, true>(key) {}
+            template< typename K > hashable_node(const K& key): hashable_node<Node, Key, true>(key) {}
             ~hashable_node() { const_cast<Key*>(&this->node().value.first)->~Key(); }
         };
-    #endif
+
+        template< typename Values, typename K, typename = void > struct values_has_heterogeneous_find: std::false_type {};
+        template< typename Values, typename K > struct values_has_heterogeneous_find<Values, K,
+            std::void_t<decltype(std::declval<const Values&>().find(std::declval<const K&>()))>>: std::true_type {};
+
+        template< typename Values, typename K, typename = void > struct values_has_prefetch: std::false_type {};
+        template< typename Values, typename K > struct values_has_prefetch<Values, K,
+            std::void_t<decltype(std::declval<const Values&>().prefetch(std::declval<const K&>()))>>: std::true_type {};
+    };
+
+    // Node store policies for evictable_unordered_map.
+    struct unordered_values {
+        template< typename Node, typename Hash, typename KeyEqual, typename Allocator >
+        using table = std::unordered_set< Node, Hash, KeyEqual, Allocator >;
+    };
+
+    struct open_addressing_values {
+        template< typename Node, typename Hash, typename KeyEqual, typename Allocator >
+        using table = detail::open_addressing_node_set< Node, Hash, KeyEqual, Allocator >;
     };
 
     template<
@@ -211,8 +900,10 @@ namespace containers {
         typename Value,
         typename Hash = std::hash<Key>,
         typename KeyEqual = std::equal_to<Key>,
-        typename Allocator = std::allocator< std::pair<const Key, Value > >,
-        typename Cache = detail::lru_cache< std::pair< const Key, Value > >
+        typename Allocator = detail::pool_allocator< std::pair<const Key, Value > >,
+        typename Cache = detail::lru_cache< std::pair< const Key, Value > >,
+        typename Values = unordered_values,
+        typename Stats = no_stats
     > class evictable_unordered_map {
     public:
         using cache_type = Cache;
@@ -222,27 +913,53 @@ namespace containers {
 
     private:    
         struct hash: Hash {
-            size_t operator()(const node_type& n) const noexcept { return static_cast<const Hash&>(*this)(n.value.first); }
-        #if __cpp_lib_generic_unordered_lookup == 201811L
             using is_transparent = void;
-            size_t operator()(const Key& key) const noexcept { return static_cast<const Hash&>(*this)(key); }
-        #endif
+            size_t operator()(const node_type& n) const noexcept { return static_cast<const Hash&>(*this)(n.value.first); }
+            template< typename K > size_t operator()(const K& key) const noexcept { return static_cast<const Hash&>(*this)(key); }
         };
 
         struct key_equal : KeyEqual {
-            size_t operator()(const node_type& lhs, const node_type& rhs) const noexcept { return static_cast<const KeyEqual&>(*this)(lhs.value.first, rhs.value.first); }
-        #if __cpp_lib_generic_unordered_lookup == 201811L
             using is_transparent = void;
-            size_t operator()(const Key& lhs, const node_type& rhs) const noexcept { return static_cast<const KeyEqual&>(*this)(lhs, rhs.value.second); }
-        #endif
+            bool operator()(const node_type& lhs, const node_type& rhs) const noexcept { return static_cast<const KeyEqual&>(*this)(lhs.value.first, rhs.value.first); }
+            template< typename K > bool operator()(const K& lhs, const node_type& rhs) const noexcept { return static_cast<const KeyEqual&>(*this)(lhs, rhs.value.first); }
+            template< typename K > bool operator()(const node_type& lhs, const K& rhs) const noexcept { return static_cast<const KeyEqual&>(*this)(lhs.value.first, rhs); }
         };
 
-        using values_type = std::unordered_set< node_type, hash, key_equal,
+        using values_type = typename Values::template table< node_type, hash, key_equal,
             typename std::allocator_traits< Allocator >::template rebind_alloc< node_type > >;
 
         cache_type cache_;
         values_type values_;
-        
+        Stats stats_;
+        size_t capacity_ = 0; // 0 means unbounded
+        std::function<void(const std::pair<const Key, Value>&)> evicted_;
+
+        // Erases the current victim through its node, the only extra hash is
+        // the victim's own key when removing it from the values.
+        void evict() {
+            auto victim = cache_.evictable();
+            assert(victim != cache_.end());
+            const node_type& n = *victim.node_;
+            if (evicted_)
+                evicted_(n.value);
+            stats_.eviction();
+            cache_.erase(n);
+            values_.erase(values_.find(n));
+        }
+
+        // Routes lookups through the values' own heterogeneous find when it
+        // has one (open_addressing_values always, std::unordered_set with
+        // generic lookup support), so no key is ever materialized. Only the
+        // remaining case copies the key into a node-shaped buffer.
+        template< typename K > typename values_type::iterator find_value(const K& key) {
+            if constexpr (detail::values_has_heterogeneous_find<values_type, K>::value) {
+                return values_.find(key);
+            } else {
+                detail::hashable_node<node_type, Key> key_node(key);
+                return values_.find(key_node.node());
+            }
+        }
+
     public:
         struct iterator {
             iterator(typename values_type::iterator it): it_(it) {}
@@ -257,7 +974,7 @@ namespace containers {
             iterator operator++(int) { typename values_type::iterator it = it_; ++it_; return it; }
 
         private:
-            template< typename KeyT, typename ValueT, typename HashT, typename KeyEqualT, typename AllocatorT, typename CacheT>
+            template< typename KeyT, typename ValueT, typename HashT, typename KeyEqualT, typename AllocatorT, typename CacheT, typename ValuesT, typename StatsT >
             friend class evictable_unordered_map;
 
             typename values_type::iterator it_;
@@ -268,23 +985,88 @@ namespace containers {
 
         template<typename... Args> std::pair<iterator, bool> emplace(Args&&... args) {
             auto it = values_.emplace(node_type{{std::forward<Args>(args)...}});
+            it.second ? stats_.insert() : stats_.update();
             cache_.emplace(*it.first, it.second);
+            if (it.second && capacity_ && values_.size() > capacity_)
+                evict();
             return {it.first, it.second};
         }
 
-        iterator find(const Key& key) {
-        #if __cpp_lib_generic_unordered_lookup == 201811L
-            auto it = values_.find(key);
-        #else
-            // This still needs to copy the key, but at least not the value.
-            detail::hashable_node<node_type, Key> key_node(key);
-            auto it = values_.find(key_node.node());
-        #endif
-            if (it != values_.end())
+        // Bounds the map to capacity entries, evicting inline from emplace().
+        // A capacity of 0 restores the manual evictable()/erase() protocol.
+        void set_capacity(size_t capacity) {
+            capacity_ = capacity;
+            while (capacity_ && values_.size() > capacity_)
+                evict();
+        }
+
+        size_t capacity() const { return capacity_; }
+
+        template< typename F > void set_eviction_callback(F&& callback) {
+            evicted_ = std::forward<F>(callback);
+        }
+
+        template< typename K > iterator find(const K& key) {
+            auto it = find_value(key);
+            if (it != values_.end()) {
+                stats_.hit();
                 cache_.touch(*it);
+            } else {
+                stats_.miss();
+            }
             return it;
         }
 
+        // Lookup that leaves the recency list untouched. With a sampling
+        // Cache policy the access is recorded in the node's atomic counter,
+        // so readers share no mutable list state and may run concurrently
+        // against a writer that is not structurally modifying the table.
+        template< typename K > iterator find_readonly(const K& key) {
+            auto it = find_value(key);
+            if (it != values_.end()) {
+                stats_.hit();
+                if constexpr (detail::cache_has_record<cache_type, node_type>::value)
+                    cache_.record(*it);
+            } else {
+                stats_.miss();
+            }
+            return it;
+        }
+
+        // Batched lookup, software-pipelined in windows: all target slots of
+        // a window are prefetched before any of them is probed (with a
+        // Values policy that supports it, open_addressing_values does), so
+        // the probes overlap their memory stalls instead of paying one per
+        // key; recency-list maintenance is likewise grouped behind the
+        // probes. Writes one iterator per key, end() for misses, and
+        // returns the advanced output iterator.
+        template< typename It, typename Out > Out find_batch(It first, It last, Out out) {
+            constexpr size_t window = 16;
+            while (first != last) {
+                typename values_type::iterator found[window];
+                size_t count = 0;
+                if constexpr (detail::values_has_prefetch<values_type, decltype(*first)>::value) {
+                    for (It key = first; key != last && count < window; ++key, ++count)
+                        values_.prefetch(*key);
+                } else {
+                    for (It key = first; key != last && count < window; ++key, ++count)
+                        ;
+                }
+                for (size_t i = 0; i < count; ++i, ++first)
+                    found[i] = find_value(*first);
+                for (size_t i = 0; i < count; ++i) {
+                    if (found[i] != values_.end()) {
+                        stats_.hit();
+                        cache_.touch(*found[i]);
+                    } else {
+                        stats_.miss();
+                    }
+                    *out++ = iterator(found[i]);
+                }
+            }
+            return out;
+        }
+
         Value& operator[](const Key& key) {
             auto it = find(key);
             if (it != end()) {
@@ -295,9 +1077,9 @@ namespace containers {
 
         size_t erase(const Key& key) {
             auto it = find(key);
-            if (it != values_.end()) {
-                cache_.erase(it->second);
-                values_.erase(it);
+            if (it != end()) {
+                cache_.erase(*it.it_);
+                values_.erase(it.it_);
                 return 1;
             }
             return 0;
@@ -318,6 +1100,7 @@ namespace containers {
 
         void touch(const iterator& it) {
             assert(it != end());
+            stats_.touch();
             cache_.touch(*it.it_);
         }
 
@@ -326,7 +1109,31 @@ namespace containers {
             if (it != end()) touch(it);
         }
 
-        const Cache& cache() { return cache_; }
+        Cache& cache() { return cache_; }
+        const Cache& cache() const { return cache_; }
+
+        // Erases all entries expired at now when the Cache policy is
+        // time-aware (ttl_cache), reporting each through the eviction
+        // callback. Returns the number of erased entries.
+        template< typename TimePoint > size_t expire(TimePoint now) {
+            auto batch = cache_.expire(now);
+            size_t count = 0;
+            for (const node_type* n = batch.head(); n; ++count) {
+                const node_type* next = n->next;
+                if (evicted_)
+                    evicted_(n->value);
+                stats_.eviction();
+                values_.erase(values_.find(*n));
+                n = next;
+            }
+            return count;
+        }
+
+        // Scrapeable counter snapshot; empty unless a counting Stats policy
+        // is selected. Size and load factor have their own accessors.
+        typename Stats::snapshot stats() const { return stats_.read(); }
+
+        float load_factor() const { return values_.load_factor(); }
 
         iterator evictable() {
             auto it = cache_.evictable();
@@ -334,5 +1141,143 @@ namespace containers {
                 return values_.find(*it.node_);
             return end();
         }
+
+        // Writes the entries in eviction order, least recently used first,
+        // so load() can rebuild both the table and the recency list in one
+        // pass. Requires a Cache policy that keeps a single recency-ordered
+        // list with the victim at the tail (lru_cache, sampled_lru_cache).
+        template< typename Stream > void save(Stream& stream) const {
+            uint64_t count = values_.size();
+            detail::snapshot_write(stream, count);
+            uint64_t written = 0;
+            for (const node_type* n = cache_.evictable().node_; n; n = n->prev, ++written) {
+                detail::snapshot_write(stream, n->value.first);
+                detail::snapshot_write(stream, n->value.second);
+            }
+            assert(written == count);
+            (void)written;
+        }
+
+        // Replaces the contents with a snapshot written by save(). The
+        // values are pre-sized to rehash once, and since the entries come
+        // least recently used first, plain emplace() restores the recency
+        // order without any relinking.
+        template< typename Stream > void load(Stream& stream) {
+            clear();
+            uint64_t count = 0;
+            detail::snapshot_read(stream, count);
+            values_.reserve(count);
+            for (uint64_t i = 0; i < count; ++i) {
+                std::pair<Key, Value> value;
+                detail::snapshot_read(stream, value.first);
+                detail::snapshot_read(stream, value.second);
+                emplace(std::move(value.first), std::move(value.second));
+            }
+        }
+    };
+
+    // Sharded wrapper over evictable_unordered_map for multi-core use. Keys
+    // are distributed over the shards by the high bits of Hash, each shard
+    // owns its own cache and values and is protected by its own mutex.
+    // Iterators are not exposed across shards, results are returned by value.
+    template<
+        typename Key,
+        typename Value,
+        typename Hash = std::hash<Key>,
+        typename KeyEqual = std::equal_to<Key>,
+        typename Allocator = detail::pool_allocator< std::pair<const Key, Value > >,
+        typename Cache = detail::lru_cache< std::pair< const Key, Value > >,
+        typename Values = unordered_values,
+        typename Stats = no_stats,
+        size_t Shards = 16
+    > class sharded_evictable_unordered_map {
+        static_assert((Shards & (Shards - 1)) == 0);
+
+        using shard_map = evictable_unordered_map<Key, Value, Hash, KeyEqual, Allocator, Cache, Values, Stats>;
+
+        struct shard {
+            mutable std::mutex mutex;
+            shard_map map;
+        };
+
+        static constexpr size_t shard_bits(size_t n) { return n < 2 ? 0 : 1 + shard_bits(n / 2); }
+
+        shard& shard_at(const Key& key) const {
+            size_t h = Hash()(key);
+            size_t index = Shards == 1 ? 0 : h >> (sizeof(size_t) * 8 - shard_bits(Shards));
+            return const_cast<shard&>(shards_[index]);
+        }
+
+        std::array<shard, Shards> shards_;
+
+    public:
+        using value_type = std::pair< const Key, Value >;
+
+        template< typename... Args > bool emplace(const Key& key, Args&&... args) {
+            auto& s = shard_at(key);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            return s.map.emplace(key, std::forward<Args>(args)...).second;
+        }
+
+        std::optional<Value> find(const Key& key) {
+            auto& s = shard_at(key);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.map.find(key);
+            if (it != s.map.end())
+                return it->second;
+            return std::nullopt;
+        }
+
+        size_t erase(const Key& key) {
+            auto& s = shard_at(key);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            return s.map.erase(key);
+        }
+
+        void touch(const Key& key) {
+            auto& s = shard_at(key);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.map.touch(key);
+        }
+
+        size_t size() const {
+            size_t size = 0;
+            for (auto& s: shards_) {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                size += s.map.size();
+            }
+            return size;
+        }
+
+        bool empty() const { return size() == 0; }
+
+        void clear() {
+            for (auto& s: shards_) {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                s.map.clear();
+            }
+        }
+
+        // Picks the victim from the most loaded shard. The choice is a
+        // snapshot, concurrent updates may change the loads underneath.
+        std::optional<Key> evictable() const {
+            size_t index = 0, max = 0;
+            for (size_t i = 0; i < Shards; ++i) {
+                std::lock_guard<std::mutex> lock(shards_[i].mutex);
+                size_t size = shards_[i].map.size();
+                if (size > max) {
+                    max = size;
+                    index = i;
+                }
+            }
+            if (max == 0)
+                return std::nullopt;
+            auto& s = const_cast<shard&>(shards_[index]);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.map.evictable();
+            if (it != s.map.end())
+                return it->first;
+            return std::nullopt;
+        }
     };
 }
@@ -8,16 +8,24 @@
 #pragma once
 
 #include <containers/allocators/deferred_allocator.h>
+#include <containers/allocators/epoch_allocator.h>
+#include <containers/stats.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cassert>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <cstdlib>
 #include <cstring>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace containers {
     namespace detail {
         template< typename... Args > struct compressed_tuple: Args... {
@@ -31,6 +39,49 @@ namespace containers {
 
         constexpr size_t log2(size_t n) { return ((n<2) ? 1 : 1 + log2(n/2)); }
 
+        // Runtime most significant bit position, compiles to a single
+        // bsr/lzcnt.
+        inline size_t msb(size_t n) {
+            assert(n);
+        #if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanReverse64(&index, n);
+            return index;
+        #else
+            return sizeof(size_t) * 8 - 1 - __builtin_clzll(n);
+        #endif
+        }
+
+        template< typename Allocator, typename = void > struct allocator_has_release: std::false_type {};
+        template< typename Allocator > struct allocator_has_release<Allocator,
+            std::void_t<decltype(std::declval<Allocator&>().release())>>: std::true_type {};
+
+        template< typename Allocator, typename = void > struct allocator_has_epochs: std::false_type {};
+        template< typename Allocator > struct allocator_has_epochs<Allocator,
+            std::void_t<typename Allocator::reader>>: std::true_type {};
+
+        // Reader-side registration with an epoch-based allocator, empty for
+        // allocators without reader tracking. Releasing the slot only flips
+        // its flag, so no back-reference to the allocator is needed.
+        template< typename Allocator, typename = void > struct reader_registration {};
+        template< typename Allocator > struct reader_registration<Allocator,
+            std::void_t<typename Allocator::reader>> {
+            typename Allocator::reader* slot = nullptr;
+            reader_registration() = default;
+            reader_registration(reader_registration&& other): slot(other.slot) { other.slot = nullptr; }
+            reader_registration& operator = (reader_registration&& other) {
+                if (slot)
+                    slot->release();
+                slot = other.slot;
+                other.slot = nullptr;
+                return *this;
+            }
+            ~reader_registration() {
+                if (slot)
+                    slot->release();
+            }
+        };
+
         template< typename T, size_t BlockSize > struct growable_array_block {
             template< typename... Args > void emplace(T* ptr, Args&&... args) {
                 new (ptr) T{std::forward<Args>(args)...};
@@ -50,6 +101,11 @@ namespace containers {
                 }
             }
 
+            void destroy(size_t first, size_t last) {
+                while (last > first)
+                    this->at(--last)->~T();
+            }
+
         protected:
             T* at(size_t n) {
                 T* ptr = reinterpret_cast<T*>(storage_.data()) + n;
@@ -59,6 +115,28 @@ namespace containers {
 
             std::array<uint8_t, sizeof(T) * BlockSize> storage_;
         };
+
+        template< typename T, size_t BlockSize > struct concurrent_growable_array_block
+            : growable_array_block<T, BlockSize> {
+            template< typename... Args > void emplace(T* ptr, Args&&... args) {
+                new (ptr) T{std::forward<Args>(args)...};
+                ready_[ptr - this->begin()].store(1, std::memory_order_release);
+            }
+
+            bool ready(size_t n) const {
+                return ready_[n].load(std::memory_order_acquire);
+            }
+
+            // Blocks are allocated as raw memory, the readiness flags need to
+            // be cleared before the block is published.
+            void reset() {
+                for (auto& ready: ready_)
+                    ready.store(0, std::memory_order_relaxed);
+            }
+
+        private:
+            std::array<std::atomic<uint8_t>, BlockSize> ready_;
+        };
     };
 
     // Single writer, multiple readers dynamic append-only array.
@@ -69,7 +147,8 @@ namespace containers {
         size_t BlocksGrowFactor = 8,
         typename Block = detail::growable_array_block<T, BlockSize>,
         typename BlockAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Block>,
-        typename BlockMapAllocator = detail::deferred_allocator<uint8_t, Allocator>
+        typename BlockMapAllocator = detail::deferred_allocator<uint8_t, Allocator>,
+        typename Stats = no_stats
     >
     class growable_array: detail::compressed_tuple<BlockAllocator, BlockMapAllocator> {
         static_assert((BlockSize & (BlockSize - 1)) == 0);
@@ -83,11 +162,33 @@ namespace containers {
 
         std::atomic<size_t> size_ = 0;
         std::atomic<block_map*> map_ = nullptr;
+        // Bumped only on map replacement so reader_state can tell its cached
+        // map apart from a replaced one without reloading map_ on every read.
+        std::atomic<size_t> map_generation_ = 0;
         size_t map_size_ = 0;
-        
+        block_type* free_blocks_ = nullptr;
+        Stats stats_;
+
         auto& block_allocator() { return this->template get<0>(); }
-        block_type* allocate_block() { return block_allocator().allocate(1); }
+        block_type* allocate_block() { stats_.block_allocation(); return block_allocator().allocate(1); }
         void deallocate_block(block_type* ptr) { return block_allocator().deallocate(ptr, 1); }
+
+        // Emptied blocks are linked through their storage for reuse by
+        // future appends instead of going back to the allocator.
+        void recycle_block(block_type* block) {
+            static_assert(sizeof(block_type) >= sizeof(block_type*));
+            *reinterpret_cast<block_type**>(block) = free_blocks_;
+            free_blocks_ = block;
+        }
+
+        block_type* acquire_block() {
+            if (free_blocks_) {
+                block_type* block = free_blocks_;
+                free_blocks_ = *reinterpret_cast<block_type**>(block);
+                return block;
+            }
+            return allocate_block();
+        }
         
         auto& byte_allocator() { return this->template get<1>(); }
         block_map* allocate_block_map(size_t n) { 
@@ -105,17 +206,63 @@ namespace containers {
             auto offset = n & (BlockSize - 1);
             return (*map_.load(std::memory_order_relaxed)->blocks[index])[offset];
         }
+
+        // Makes block index addressable, growing the block map if needed. The
+        // new map is published relaxed, ordering is provided by the release
+        // store of size_ when the elements are published.
+        block_type* ensure_block(size_t index) {
+            auto map = map_.load(std::memory_order_relaxed);
+            if (index < map_size_)
+                return map->blocks[index];
+            assert(index == map_size_);
+            if (!map || map_size_ == map->capacity_) {
+                auto capacity = map ? map->capacity_ * BlocksGrowFactor : BlocksGrowFactor;
+                stats_.map_growth();
+                auto new_map = allocate_block_map(capacity);
+                if (map)
+                    std::memcpy(new_map->blocks, map->blocks, sizeof(block_type*) * map_size_);
+                new_map->capacity_ = capacity;
+                // Published release so a reader reloading the map through
+                // its acquire also sees the copied block pointers; the bump
+                // tells cached reader_states to reload.
+                map_.store(new_map, std::memory_order_release);
+                map_generation_.fetch_add(1, std::memory_order_release);
+                // The old map may still be observed by readers that loaded
+                // it before the publish, reclamation is deferred until the
+                // allocator deems it safe.
+                if (map)
+                    deallocate_block_map(map);
+                map = new_map;
+            }
+            map->blocks[map_size_] = acquire_block();
+            ++map_size_;
+            return map->blocks[index];
+        }
     public:
         using value_type = T;
         
+        // Besides the size snapshot, the state caches the block map and the
+        // last-touched block, stamped with the map generation. Sequential
+        // reads within a block then touch only the state itself; the map is
+        // reloaded only when a read crosses a block boundary after the
+        // writer replaced the map.
         class reader_state {
-            template< typename U, typename AllocatorU, size_t, size_t, typename, typename, typename > friend class growable_array;
+            template< typename U, typename AllocatorU, size_t, size_t, typename, typename, typename, typename > friend class growable_array;
             size_t size = 0;
+            size_t generation = 0;
+            block_map* map = nullptr;
+            size_t block_index = size_t(-1);
+            block_type* block = nullptr;
+            detail::reader_registration<BlockMapAllocator> reader_;
         };
 
         growable_array() = default;
         growable_array(Allocator allocator):
-            detail::compressed_tuple<BlockAllocator, BlockMapAllocator>(allocator) {} 
+            detail::compressed_tuple<BlockAllocator, BlockMapAllocator>(allocator) {}
+        explicit growable_array(size_t capacity, Allocator allocator = {}):
+            detail::compressed_tuple<BlockAllocator, BlockMapAllocator>(allocator) {
+            reserve(capacity);
+        }
 
         growable_array(const growable_array&) = delete;
         growable_array& operator = (const growable_array&) = delete;
@@ -124,30 +271,447 @@ namespace containers {
             clear();
         }
         
+        void clear() {
+            // Bulk teardown: with trivially destructible elements and blocks
+            // owned by an arena, dropping the arena's chunks replaces the
+            // per-block walk, see detail::arena_allocator.
+            if constexpr (std::is_trivially_destructible_v<T> && detail::allocator_has_release<BlockAllocator>::value) {
+                size_.store(0, std::memory_order_relaxed);
+                if (auto map = map_.load(std::memory_order_relaxed)) {
+                    deallocate_block_map(map);
+                    map_.store(nullptr, std::memory_order_relaxed);
+                    map_generation_.fetch_add(1, std::memory_order_relaxed);
+                }
+                map_size_ = 0;
+                free_blocks_ = nullptr;
+                block_allocator().release();
+                byte_allocator().reset();
+                return;
+            }
+            if (auto map = map_.load(std::memory_order_relaxed)) {
+                auto size = size_.exchange(0, std::memory_order_relaxed);
+                while (map_size_) {
+                    --map_size_;
+                    if (!std::is_trivially_destructible_v<T>) {
+                        // Blocks allocated by reserve() past the published
+                        // size hold no constructed elements.
+                        auto count = size > map_size_ * BlockSize
+                            ? std::min<size_t>(size - map_size_ * BlockSize, BlockSize) : 0;
+                        map->blocks[map_size_]->destroy(count);
+                        size -= count;
+                    }
+                    deallocate_block(map->blocks[map_size_]);
+                }
+
+                deallocate_block_map(map);
+                map_.store(nullptr, std::memory_order_relaxed);
+                map_generation_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            while (free_blocks_)
+                deallocate_block(acquire_block());
+
+            byte_allocator().reset();
+        }
+
+        // Pre-allocates the block map and all blocks needed for n elements,
+        // hoisting the allocator out of the append loop. Touching writes the
+        // reserved blocks once so appends fault in no pages.
+        void reserve(size_t n, bool touch = false) {
+            size_t blocks = (n + BlockSize - 1) >> (detail::log2(BlockSize) - 1);
+            while (map_size_ < blocks) {
+                auto block = ensure_block(map_size_);
+                if (touch)
+                    std::memset(reinterpret_cast<void*>(block), 0, sizeof(block_type));
+            }
+        }
+
+        size_t capacity() const { return map_size_ * BlockSize; }
+
+        // Destroys elements at indices [n, size()) and recycles whole emptied
+        // blocks for reuse by future appends. Writer-side operation; readers
+        // must not access the removed range concurrently.
+        void resize_down(size_t n) {
+            size_t size = size_.load(std::memory_order_relaxed);
+            if (n >= size)
+                return;
+            auto map = map_.load(std::memory_order_relaxed);
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                size_t s = size;
+                while (s > n) {
+                    size_t index = (s - 1) >> (detail::log2(BlockSize) - 1);
+                    size_t begin = index * BlockSize;
+                    size_t from = n > begin ? n - begin : 0;
+                    map->blocks[index]->destroy(from, s - begin);
+                    s = begin + from;
+                }
+            }
+            size_t keep = (n + BlockSize - 1) >> (detail::log2(BlockSize) - 1);
+            if (map_size_ > keep) {
+                // Recycled blocks may come back under the same index with a
+                // different address, invalidate cached block pointers.
+                map_generation_.fetch_add(1, std::memory_order_relaxed);
+                while (map_size_ > keep)
+                    recycle_block(map->blocks[--map_size_]);
+            }
+            size_.store(n, std::memory_order_release);
+        }
+
+        void pop_back_n(size_t n) {
+            size_t size = size_.load(std::memory_order_relaxed);
+            resize_down(size - std::min(n, size));
+        }
+
+        const T& operator[](size_t n) const {
+            return const_cast<growable_array<T>&>(*this)->operator[](n);
+        }
+
+        T& operator[](size_t n) {
+            return read(size_.load(std::memory_order_acquire), n);
+        }
+
+        T& read(reader_state& state, size_t n) {
+            if constexpr (detail::allocator_has_epochs<BlockMapAllocator>::value) {
+                if (!state.reader_.slot)
+                    state.reader_.slot = byte_allocator().register_reader();
+                byte_allocator().announce(*state.reader_.slot);
+                // A map cached from an earlier epoch may be reclaimed once a
+                // newer one is announced; blocks themselves are stable.
+                state.map = nullptr;
+            }
+            if (n >= state.size)
+                state.size = size_.load(std::memory_order_acquire);
+            assert(n < state.size);
+            size_t index = n >> (detail::log2(BlockSize) - 1);
+            // Map entries for published blocks are stable, so the cached map
+            // and block stay usable until the generation moves; the acquire
+            // loads pair with the release publish in ensure_block, making
+            // the copied block pointers of a reloaded map visible.
+            size_t generation = map_generation_.load(std::memory_order_acquire);
+            if (index != state.block_index || generation != state.generation) {
+                if (generation != state.generation || !state.map) {
+                    state.generation = generation;
+                    state.map = map_.load(std::memory_order_acquire);
+                }
+                state.block_index = index;
+                state.block = state.map->blocks[index];
+            }
+            return (*state.block)[n & (BlockSize - 1)];
+        }
+
+        size_t size() const { return size_.load(std::memory_order_acquire); }
+        size_t empty() const { return size_.load(std::memory_order_acquire) == 0; }
+
+        // Contiguous view of one block, suitable for vectorized scans.
+        struct block_span {
+            T* begin() const { return data_; }
+            T* end() const { return data_ + size_; }
+            T* data() const { return data_; }
+            size_t size() const { return size_; }
+            T& operator[](size_t n) const { return data_[n]; }
+
+            T* data_;
+            size_t size_;
+        };
+
+        class block_iterator {
+            friend class growable_array;
+            block_iterator(block_map* map, size_t index, size_t size):
+                map_(map), index_(index), size_(size) {}
+
+            block_map* map_;
+            size_t index_;
+            size_t size_;
+        public:
+            block_span operator*() const {
+                return { map_->blocks[index_]->begin(),
+                    std::min<size_t>(BlockSize, size_ - index_ * BlockSize) };
+            }
+
+            bool operator == (const block_iterator& other) const { return index_ == other.index_; }
+            bool operator != (const block_iterator& other) const { return index_ != other.index_; }
+
+            block_iterator& operator++() { ++index_; return *this; }
+            block_iterator operator++(int) { block_iterator it = *this; ++index_; return it; }
+        };
+
+        class blocks_view {
+            friend class growable_array;
+            blocks_view(block_map* map, size_t size): map_(map), size_(size) {}
+
+            block_map* map_;
+            size_t size_;
+        public:
+            block_iterator begin() const { return block_iterator(map_, 0, size_); }
+            block_iterator end() const {
+                return block_iterator(map_, (size_ + BlockSize - 1) >> (detail::log2(BlockSize) - 1), size_);
+            }
+        };
+
+        // Random-access iterator over a size_ snapshot. The current block
+        // pointer is cached and recomputed only when an access crosses a
+        // block boundary, so sequential sweeps walk the block map once per
+        // block; arithmetic touches just the element index, which keeps
+        // partitioning by parallel algorithms cheap.
+        class iterator {
+            friend class growable_array;
+            iterator(block_map* map, size_t index):
+                map_(map), index_(index) {}
+
+            block_map* map_;
+            size_t index_;
+            mutable size_t block_index_ = size_t(-1);
+            mutable block_type* block_ = nullptr;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            iterator() : map_(nullptr), index_(0) {}
+
+            reference operator*() const {
+                size_t index = index_ >> (detail::log2(BlockSize) - 1);
+                if (index != block_index_) {
+                    block_index_ = index;
+                    block_ = map_->blocks[index];
+                }
+                return (*block_)[index_ & (BlockSize - 1)];
+            }
+
+            pointer operator->() const { return &operator*(); }
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+            iterator& operator++() { ++index_; return *this; }
+            iterator operator++(int) { iterator it = *this; ++index_; return it; }
+            iterator& operator--() { --index_; return *this; }
+            iterator operator--(int) { iterator it = *this; --index_; return it; }
+
+            iterator& operator += (difference_type n) { index_ += n; return *this; }
+            iterator& operator -= (difference_type n) { index_ -= n; return *this; }
+
+            friend iterator operator + (iterator it, difference_type n) { it += n; return it; }
+            friend iterator operator + (difference_type n, iterator it) { it += n; return it; }
+            friend iterator operator - (iterator it, difference_type n) { it -= n; return it; }
+            friend difference_type operator - (const iterator& lhs, const iterator& rhs) {
+                return lhs.index_ - rhs.index_;
+            }
+
+            friend bool operator == (const iterator& lhs, const iterator& rhs) { return lhs.index_ == rhs.index_; }
+            friend bool operator != (const iterator& lhs, const iterator& rhs) { return lhs.index_ != rhs.index_; }
+            friend bool operator < (const iterator& lhs, const iterator& rhs) { return lhs.index_ < rhs.index_; }
+            friend bool operator > (const iterator& lhs, const iterator& rhs) { return lhs.index_ > rhs.index_; }
+            friend bool operator <= (const iterator& lhs, const iterator& rhs) { return lhs.index_ <= rhs.index_; }
+            friend bool operator >= (const iterator& lhs, const iterator& rhs) { return lhs.index_ >= rhs.index_; }
+        };
+
+        iterator begin() {
+            size_t size = size_.load(std::memory_order_acquire);
+            return iterator(size ? map_.load(std::memory_order_relaxed) : nullptr, 0);
+        }
+
+        iterator end() {
+            size_t size = size_.load(std::memory_order_acquire);
+            return iterator(size ? map_.load(std::memory_order_relaxed) : nullptr, size);
+        }
+
+        // Snapshot of the published elements as per-block contiguous spans,
+        // walking the block map once instead of per element.
+        blocks_view blocks() {
+            size_t size = size_.load(std::memory_order_acquire);
+            return blocks_view(size ? map_.load(std::memory_order_relaxed) : nullptr, size);
+        }
+
+        template< typename F > void for_each(F&& f) {
+            for (auto span: blocks())
+                for (auto& value: span)
+                    f(value);
+        }
+
+        template< typename V, typename F > V reduce(V init, F&& f) {
+            for (auto span: blocks())
+                for (auto& value: span)
+                    init = f(std::move(init), value);
+            return init;
+        }
+
+        template< typename... Args > size_t emplace_back(Args&&... args) {
+            size_t size = size_.load(std::memory_order_relaxed);
+            size_t offset = size & (BlockSize - 1);
+            auto block = ensure_block(size >> (detail::log2(BlockSize) - 1));
+            block->emplace(block->begin() + offset, std::forward<Args>(args)...);
+            stats_.append();
+            size_.store(size + 1, std::memory_order_release);
+            return size + 1;
+        }
+
+        // Appends [first, last), filling whole contiguous runs per block and
+        // publishing the new size with a single release store at the end.
+        template< typename It > size_t append(It first, It last) {
+            size_t size = size_.load(std::memory_order_relaxed);
+            size_t n = size;
+            while (first != last) {
+                size_t offset = n & (BlockSize - 1);
+                size_t count = std::min<size_t>(BlockSize - offset, std::distance(first, last));
+                auto block = ensure_block(n >> (detail::log2(BlockSize) - 1));
+                if constexpr (std::is_pointer_v<It> && std::is_trivially_copyable_v<T>) {
+                    std::memcpy(block->begin() + offset, first, sizeof(T) * count);
+                    first += count;
+                } else {
+                    for (size_t i = 0; i < count; ++i)
+                        block->emplace(block->begin() + offset + i, *first++);
+                }
+                n += count;
+            }
+            if (n != size) {
+                stats_.append(n - size);
+                size_.store(n, std::memory_order_release);
+            }
+            return n;
+        }
+
+        size_t push_back(const T& value) { return emplace_back(value); }
+        size_t push_back(T&& value) { return emplace_back(std::move(value)); }
+
+        // Scrapeable counter snapshot; empty unless a counting Stats policy
+        // is selected.
+        typename Stats::snapshot stats() const { return stats_.read(); }
+    };
+
+    // Multiple writers, multiple readers dynamic append-only array.
+    // emplace_back() claims a slot with fetch_add and publishes its readiness
+    // through the block, so writers only serialize when a new block is needed.
+    template<
+        typename T,
+        typename Allocator = std::allocator<T>,
+        size_t BlockSize = 128,
+        size_t BlocksGrowFactor = 8,
+        typename Block = detail::concurrent_growable_array_block<T, BlockSize>,
+        typename BlockAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Block>,
+        typename BlockMapAllocator = detail::deferred_allocator<uint8_t, Allocator>
+    >
+    class concurrent_growable_array: detail::compressed_tuple<BlockAllocator, BlockMapAllocator> {
+        static_assert((BlockSize & (BlockSize - 1)) == 0);
+
+        using block_type = Block;
+
+        struct block_map {
+            size_t capacity_ = 0;
+            block_type* blocks[0];
+        };
+
+        std::atomic<size_t> size_ = 0;
+        std::atomic<size_t> capacity_ = 0;
+        std::atomic<block_map*> map_ = nullptr;
+        size_t map_size_ = 0;
+        std::mutex growth_mutex_;
+
+        auto& block_allocator() { return this->template get<0>(); }
+        block_type* allocate_block() {
+            block_type* block = block_allocator().allocate(1);
+            block->reset();
+            return block;
+        }
+        void deallocate_block(block_type* ptr) { return block_allocator().deallocate(ptr, 1); }
+
+        auto& byte_allocator() { return this->template get<1>(); }
+        block_map* allocate_block_map(size_t n) {
+            return (block_map*)byte_allocator().allocate(sizeof(block_map) + sizeof(block_type*) * n);
+        }
+        void deallocate_block_map(block_map* ptr) {
+            byte_allocator().reclaim((uint8_t*)ptr, sizeof(block_map) + sizeof(block_type*) * ptr->capacity_);
+        }
+
+        // Allocates blocks until slot n is addressable. Writers racing for the
+        // same block serialize here, all other writers stay on the fast path.
+        void grow(size_t n) {
+            std::lock_guard<std::mutex> lock(growth_mutex_);
+            while (capacity_.load(std::memory_order_relaxed) <= n) {
+                auto map = map_.load(std::memory_order_relaxed);
+                if (!map || map_size_ == map->capacity_) {
+                    auto capacity = map ? map->capacity_ * BlocksGrowFactor : BlocksGrowFactor;
+                    auto new_map = allocate_block_map(capacity);
+                    if (map)
+                        std::memcpy(new_map->blocks, map->blocks, sizeof(block_type*) * map_size_);
+                    new_map->capacity_ = capacity;
+                    map_.store(new_map, std::memory_order_release);
+                    // The old map may still be observed by readers and writers,
+                    // reclamation is deferred until clear().
+                    if (map)
+                        deallocate_block_map(map);
+                    map = new_map;
+                }
+                map->blocks[map_size_] = allocate_block();
+                ++map_size_;
+                capacity_.store(map_size_ * BlockSize, std::memory_order_release);
+            }
+        }
+
+        T& read(size_t size, size_t n) {
+            assert(n < size);
+            (void)size;
+            while (capacity_.load(std::memory_order_acquire) <= n)
+                ; // the claiming writer is still allocating the block
+            // Acquire pairs with the release publish in grow(): the map may
+            // come from a later growth iteration than the capacity above,
+            // whose copied block pointers must be visible.
+            auto map = map_.load(std::memory_order_acquire);
+            assert(map);
+            auto index = n >> (detail::log2(BlockSize) - 1);
+            auto offset = n & (BlockSize - 1);
+            auto block = map->blocks[index];
+            while (!block->ready(offset))
+                ; // the claiming writer is still constructing the element
+            return (*block)[offset];
+        }
+    public:
+        using value_type = T;
+
+        class reader_state {
+            template< typename U, typename AllocatorU, size_t, size_t, typename, typename, typename > friend class concurrent_growable_array;
+            size_t size = 0;
+        };
+
+        concurrent_growable_array() = default;
+        concurrent_growable_array(Allocator allocator):
+            detail::compressed_tuple<BlockAllocator, BlockMapAllocator>(allocator) {}
+
+        concurrent_growable_array(const concurrent_growable_array&) = delete;
+        concurrent_growable_array& operator = (const concurrent_growable_array&) = delete;
+
+        ~concurrent_growable_array() {
+            clear();
+        }
+
+        // Requires quiescence, no writer or reader may be active.
         void clear() {
             if (map_size_ > 0) {
                 auto map = map_.load(std::memory_order_relaxed);
                 assert(map);
                 auto size = size_.exchange(0, std::memory_order_relaxed);
+                capacity_.store(0, std::memory_order_relaxed);
                 do {
                     --map_size_;
                     if (!std::is_trivially_destructible_v<T>) {
-                        auto count = size & (BlockSize - 1);
+                        auto count = std::min<size_t>(size - map_size_ * BlockSize, BlockSize);
                         map->blocks[map_size_]->destroy(count);
                         size -= count;
                     }
                     deallocate_block(map->blocks[map_size_]);
                 } while (map_size_);
-                
+
                 deallocate_block_map(map);
+                map_.store(nullptr, std::memory_order_relaxed);
                 map_size_ = 0;
-                
+
                 byte_allocator().reset();
             }
         }
 
         const T& operator[](size_t n) const {
-            return const_cast<growable_array<T>&>(*this)->operator[](n);
+            return const_cast<concurrent_growable_array&>(*this)[n];
         }
 
         T& operator[](size_t n) {
@@ -164,46 +728,144 @@ namespace containers {
         size_t empty() const { return size_.load(std::memory_order_acquire) == 0; }
 
         template< typename... Args > size_t emplace_back(Args&&... args) {
-            size_t size = size_.load(std::memory_order_relaxed); 
-            size_t index = size >> (detail::log2(BlockSize) - 1);
-            size_t offset = size & (BlockSize - 1);
+            size_t n = size_.fetch_add(1, std::memory_order_relaxed);
+            if (capacity_.load(std::memory_order_acquire) <= n)
+                grow(n);
+            // Acquire pairs with the release publish in grow(): a concurrent
+            // writer may have replaced the map since the capacity check.
+            auto map = map_.load(std::memory_order_acquire);
+            assert(map);
+            auto index = n >> (detail::log2(BlockSize) - 1);
+            auto offset = n & (BlockSize - 1);
+            map->blocks[index]->emplace(
+                map->blocks[index]->begin() + offset, std::forward<Args>(args)...);
+            return n + 1;
+        }
 
-            if (map_size_) {
-                auto map = map_.load(std::memory_order_relaxed);
-                assert(map);
-                if (index < map_size_) {
-                insert:
-                    map->blocks[index]->emplace(
-                        map->blocks[index]->begin() + offset, std::forward<Args>(args)...);
-                    size_.store(size + 1, std::memory_order_release);
-                    return size + 1;
-                } else if (map_size_ < map->capacity_) {
-                    map->blocks[map_size_] = allocate_block();
-                    ++map_size_;
-                    goto insert;
-                } else {
-                    auto capacity = map->capacity_;
-                    auto new_map = allocate_block_map(capacity * BlocksGrowFactor);
-                    std::memcpy(new_map->blocks, map->blocks, sizeof(block_type*) * capacity);
-                    new_map->blocks[map_size_] = allocate_block();
-                    ++map_size_;
-                    new_map->capacity_ = capacity * BlocksGrowFactor;
-                    deallocate_block_map(map);
-                    map_.store(new_map, std::memory_order_relaxed);
-                    map = new_map;
-                    goto insert;
-                }
+        size_t push_back(const T& value) { return emplace_back(value); }
+        size_t push_back(T&& value) { return emplace_back(std::move(value)); }
+    };
+
+    // Single writer, multiple readers append-only array with geometric block
+    // sizing: the first InitialSize elements live inline in the container, so
+    // small arrays make no allocation at all, and each further block doubles
+    // in size, so large arrays touch few block pointers. With element n
+    // biased by InitialSize, the block index and offset both fall out of the
+    // position of the top bit, one bsr instead of the fixed shift. The spill
+    // block pointer table is allocated once at its maximum size (one pointer
+    // per doubling, 64 - log2(InitialSize) entries), so it is never
+    // republished and readers are ordered by the release store of size_.
+    template<
+        typename T,
+        size_t InitialSize = 4,
+        typename Allocator = std::allocator<T>,
+        typename PointerAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T*>
+    >
+    class geometric_growable_array: detail::compressed_tuple<Allocator, PointerAllocator> {
+        static_assert((InitialSize & (InitialSize - 1)) == 0);
+
+        static constexpr size_t initial_bits = detail::log2(InitialSize) - 1;
+        static constexpr size_t max_blocks = sizeof(size_t) * 8 - initial_bits - 1;
+
+        std::atomic<size_t> size_ = 0;
+        std::atomic<T**> blocks_ = nullptr;
+        std::aligned_storage_t<sizeof(T) * InitialSize, alignof(T)> inline_;
+
+        auto& allocator() { return this->template get<0>(); }
+        auto& pointer_allocator() { return this->template get<1>(); }
+
+        T* inline_data() { return reinterpret_cast<T*>(&inline_); }
+
+        // Spill block j holds biased positions [1 << (initial_bits + 1 + j),
+        // 1 << (initial_bits + 2 + j)), InitialSize << (j + 1) elements.
+        static constexpr size_t block_size(size_t j) { return InitialSize << (j + 1); }
+
+        T& element(size_t n) {
+            if (n < InitialSize)
+                return inline_data()[n];
+            size_t p = n + InitialSize;
+            size_t top = detail::msb(p);
+            return blocks_.load(std::memory_order_relaxed)[top - initial_bits - 1][p - (size_t(1) << top)];
+        }
+
+        T& read(size_t size, size_t n) {
+            assert(n < size);
+            (void)size;
+            return element(n);
+        }
+
+    public:
+        using value_type = T;
+
+        class reader_state {
+            template< typename U, size_t, typename, typename > friend class geometric_growable_array;
+            size_t size = 0;
+        };
+
+        geometric_growable_array() = default;
+        geometric_growable_array(Allocator alloc):
+            detail::compressed_tuple<Allocator, PointerAllocator>(alloc) {}
+
+        geometric_growable_array(const geometric_growable_array&) = delete;
+        geometric_growable_array& operator = (const geometric_growable_array&) = delete;
+
+        ~geometric_growable_array() {
+            clear();
+        }
+
+        void clear() {
+            size_t size = size_.exchange(0, std::memory_order_relaxed);
+            if (!std::is_trivially_destructible_v<T>) {
+                for (size_t n = 0; n < size; ++n)
+                    element(n).~T();
+            }
+            if (auto blocks = blocks_.load(std::memory_order_relaxed)) {
+                for (size_t j = 0; j < max_blocks && blocks[j]; ++j)
+                    allocator().deallocate(blocks[j], block_size(j));
+                pointer_allocator().deallocate(blocks, max_blocks);
+                blocks_.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        const T& operator[](size_t n) const {
+            return const_cast<geometric_growable_array&>(*this)[n];
+        }
+
+        T& operator[](size_t n) {
+            return read(size_.load(std::memory_order_acquire), n);
+        }
+
+        T& read(reader_state& state, size_t n) {
+            if (n >= state.size)
+                state.size = size_.load(std::memory_order_acquire);
+            return read(state.size, n);
+        }
+
+        size_t size() const { return size_.load(std::memory_order_acquire); }
+        bool empty() const { return size_.load(std::memory_order_acquire) == 0; }
+
+        template< typename... Args > size_t emplace_back(Args&&... args) {
+            size_t size = size_.load(std::memory_order_relaxed);
+            T* ptr;
+            if (size < InitialSize) {
+                ptr = inline_data() + size;
             } else {
-                auto new_map = allocate_block_map(BlocksGrowFactor);
-                new_map->blocks[0] = allocate_block();
-                new_map->capacity_ = BlocksGrowFactor;
-                new_map->blocks[0]->emplace(new_map->blocks[0]->begin(), std::forward<Args>(args)...);
-                
-                map_.store(new_map, std::memory_order_relaxed);
-                map_size_ = 1;
-                size_.store(1, std::memory_order_release);
-                return 1;
+                size_t p = size + InitialSize;
+                size_t top = detail::msb(p);
+                auto blocks = blocks_.load(std::memory_order_relaxed);
+                if (!blocks) {
+                    blocks = pointer_allocator().allocate(max_blocks);
+                    std::memset(blocks, 0, sizeof(T*) * max_blocks);
+                    blocks_.store(blocks, std::memory_order_relaxed);
+                }
+                size_t j = top - initial_bits - 1;
+                if (p == size_t(1) << top)
+                    blocks[j] = allocator().allocate(block_size(j));
+                ptr = blocks[j] + (p - (size_t(1) << top));
             }
+            new (ptr) T{std::forward<Args>(args)...};
+            size_.store(size + 1, std::memory_order_release);
+            return size + 1;
         }
 
         size_t push_back(const T& value) { return emplace_back(value); }
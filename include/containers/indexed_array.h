@@ -0,0 +1,174 @@
+//
+// This file is part of containers project <https://github.com/romanpauk/containers>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <containers/growable_array.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace containers {
+    // Single writer, multiple readers append-only map: values live in a
+    // growable_array (stable addresses, concurrent readers) and a hash index
+    // maps keys to their array positions. Index slots publish the position
+    // with a release store after the element itself is published through the
+    // array's size_, and a regrown index table is republished as a whole with
+    // its predecessors reclaimed through the deferred allocator, so
+    // read(reader_state&, key) is wait-free under the same scheme
+    // growable_array::read already uses. Erase is not provided, matching the
+    // append-only array underneath.
+    template<
+        typename Key,
+        typename T,
+        typename Hash = std::hash<Key>,
+        typename KeyEqual = std::equal_to<Key>,
+        typename Allocator = std::allocator< std::pair<const Key, T> >
+    >
+    class indexed_array: Hash, KeyEqual {
+        using values_type = growable_array<std::pair<const Key, T>, Allocator>;
+
+        struct slot {
+            size_t hash_;
+            std::atomic<size_t> index_; // array index + 1, 0 means empty
+        };
+
+        struct index_table {
+            size_t capacity_ = 0;
+            slot slots[0];
+        };
+
+        values_type values_;
+        std::atomic<index_table*> table_ = nullptr;
+        size_t used_ = 0;
+        detail::deferred_allocator<uint8_t, Allocator> table_allocator_;
+
+        template< typename K > size_t hash(const K& key) const { return static_cast<const Hash&>(*this)(key); }
+        template< typename K > bool equal(const K& lhs, const Key& rhs) const { return static_cast<const KeyEqual&>(*this)(lhs, rhs); }
+
+        index_table* allocate_table(size_t capacity) {
+            auto table = (index_table*)table_allocator_.allocate(sizeof(index_table) + sizeof(slot) * capacity);
+            std::memset(reinterpret_cast<void*>(table->slots), 0, sizeof(slot) * capacity);
+            table->capacity_ = capacity;
+            return table;
+        }
+
+        // Writer-side regrowth: the new table is filled and then published
+        // as a whole, the old one stays readable until reclaimed.
+        index_table* grow(index_table* table) {
+            auto capacity = table ? table->capacity_ * 2 : 16;
+            auto new_table = allocate_table(capacity);
+            if (table) {
+                for (size_t i = 0; i < table->capacity_; ++i) {
+                    auto& s = table->slots[i];
+                    size_t index = s.index_.load(std::memory_order_relaxed);
+                    if (!index)
+                        continue;
+                    size_t j = s.hash_ & (capacity - 1);
+                    while (new_table->slots[j].index_.load(std::memory_order_relaxed))
+                        j = (j + 1) & (capacity - 1);
+                    new_table->slots[j].hash_ = s.hash_;
+                    new_table->slots[j].index_.store(index, std::memory_order_relaxed);
+                }
+            }
+            table_.store(new_table, std::memory_order_release);
+            if (table)
+                table_allocator_.reclaim((uint8_t*)table, sizeof(index_table) + sizeof(slot) * table->capacity_);
+            return new_table;
+        }
+
+    public:
+        using value_type = std::pair<const Key, T>;
+
+        class reader_state {
+            template< typename KeyT, typename U, typename, typename, typename > friend class indexed_array;
+            typename values_type::reader_state state_;
+        };
+
+        indexed_array() = default;
+        indexed_array(const indexed_array&) = delete;
+        indexed_array& operator = (const indexed_array&) = delete;
+
+        ~indexed_array() {
+            clear();
+        }
+
+        // Writer-side operation; requires no readers, like
+        // growable_array::clear.
+        void clear() {
+            values_.clear();
+            if (auto table = table_.load(std::memory_order_relaxed)) {
+                table_allocator_.reclaim((uint8_t*)table, sizeof(index_table) + sizeof(slot) * table->capacity_);
+                table_.store(nullptr, std::memory_order_relaxed);
+            }
+            table_allocator_.reset();
+            used_ = 0;
+        }
+
+        template< typename... Args > bool emplace(const Key& key, Args&&... args) {
+            auto table = table_.load(std::memory_order_relaxed);
+            if (!table || (used_ + 1) * 4 > table->capacity_ * 3)
+                table = grow(table);
+            size_t h = this->hash(key);
+            size_t mask = table->capacity_ - 1;
+            size_t i = h & mask;
+            while (true) {
+                auto& s = table->slots[i];
+                size_t index = s.index_.load(std::memory_order_relaxed);
+                if (!index)
+                    break;
+                if (s.hash_ == h && equal(key, values_[index - 1].first))
+                    return false;
+                i = (i + 1) & mask;
+            }
+            size_t index = values_.emplace_back(key, T(std::forward<Args>(args)...));
+            table->slots[i].hash_ = h;
+            table->slots[i].index_.store(index, std::memory_order_release);
+            ++used_;
+            return true;
+        }
+
+        // Wait-free reader-side lookup. Returns nullptr when the key is not
+        // (yet) published; a non-null result stays valid until clear().
+        template< typename K > const T* read(reader_state& state, const K& key) {
+            auto table = table_.load(std::memory_order_acquire);
+            if (!table)
+                return nullptr;
+            size_t h = this->hash(key);
+            size_t mask = table->capacity_ - 1;
+            size_t i = h & mask;
+            while (true) {
+                auto& s = table->slots[i];
+                size_t index = s.index_.load(std::memory_order_acquire);
+                if (!index)
+                    return nullptr;
+                if (s.hash_ == h) {
+                    auto& value = values_.read(state.state_, index - 1);
+                    if (equal(key, value.first))
+                        return &value.second;
+                }
+                i = (i + 1) & mask;
+            }
+        }
+
+        // Writer-side lookup.
+        template< typename K > T* find(const K& key) {
+            reader_state state;
+            return const_cast<T*>(read(state, key));
+        }
+
+        // Values in insertion order, the array's own iteration.
+        values_type& values() { return values_; }
+
+        size_t size() const { return values_.size(); }
+        bool empty() const { return values_.empty(); }
+    };
+}
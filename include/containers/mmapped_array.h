@@ -7,19 +7,151 @@
 
 #pragma once
 
+#include <containers/allocators/numa_allocator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
 #include <memory>
+#include <thread>
 
 #if defined(__linux__)
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 namespace containers {
 
 #if defined(__linux__)
-    template< typename T, size_t Capacity = 1 << 30 > class mmapped_array {
-        static constexpr size_t capacity_ = Capacity;
+    // Mapping policies for mmapped_array. A policy reserves address space for
+    // the array's capacity, commits pages behind the growth watermark and
+    // releases everything on destruction. Committing through mprotect leaves
+    // data_ in place, so readers never observe the array moving.
+    struct anonymous_mapping {
+        void* reserve(size_t capacity) {
+            void* data = mmap(0, capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if ((uintptr_t)data == (uintptr_t)-1)
+                std::abort();
+            return data;
+        }
+
+        void commit(void* data, size_t offset, size_t size) {
+            if (mprotect((uint8_t*)data + offset, size, PROT_READ | PROT_WRITE) != 0)
+                std::abort();
+            madvise((uint8_t*)data + offset, size, MADV_WILLNEED);
+        }
+
+        void unmap(void* data, size_t capacity) { munmap(data, capacity); }
+    };
+
+    // Anonymous mapping advised towards transparent huge pages, reducing TLB
+    // pressure on large arrays without requiring reserved huge pages.
+    struct transparent_hugepage_mapping: anonymous_mapping {
+        void commit(void* data, size_t offset, size_t size) {
+            anonymous_mapping::commit(data, offset, size);
+        #if defined(MADV_HUGEPAGE)
+            madvise((uint8_t*)data + offset, size, MADV_HUGEPAGE);
+        #endif
+        }
+    };
+
+    // Anonymous mapping interleaved across the NUMA nodes in the mask, so
+    // scan-heavy readers on either socket pay cross-socket latency for only
+    // part of the array instead of all of it. Placement is advisory, see
+    // detail::mbind_pages.
+    struct numa_interleaved_mapping: anonymous_mapping {
+        // The kernel rejects masks with unavailable nodes, so the default
+        // targets the common two-socket case; on one node the mbind is
+        // ignored and nothing needed interleaving anyway.
+        numa_interleaved_mapping(unsigned long nodemask = 0x3): nodemask_(nodemask) {}
+
+        void commit(void* data, size_t offset, size_t size) {
+            anonymous_mapping::commit(data, offset, size);
+            detail::mbind_pages((uint8_t*)data + offset, size, detail::numa_mode::interleave, nodemask_);
+        }
+
+    private:
+        unsigned long nodemask_;
+    };
+
+    // Mapping carved from pre-reserved huge pages (vm.nr_hugepages).
+    struct hugetlb_mapping {
+        void* reserve(size_t capacity) {
+            void* data = mmap(0, capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_NORESERVE, -1, 0);
+            if ((uintptr_t)data == (uintptr_t)-1)
+                std::abort();
+            return data;
+        }
+
+        void commit(void* data, size_t offset, size_t size) {
+            if (mprotect((uint8_t*)data + offset, size, PROT_READ | PROT_WRITE) != 0)
+                std::abort();
+        }
+
+        void unmap(void* data, size_t capacity) { munmap(data, capacity); }
+    };
+
+    // Shared file-backed mapping. The file is grown along with the committed
+    // pages, so an array can be persisted and re-mapped at startup instead of
+    // rebuilt; pass the element count of the persisted data to the array
+    // constructor to resume reading where the writer left off.
+    struct file_mapping {
+        file_mapping(int fd, off_t offset = 0): fd_(fd), offset_(offset) {}
+
+        void* reserve(size_t capacity) {
+            void* data = mmap(0, capacity, PROT_NONE, MAP_SHARED | MAP_NORESERVE, fd_, offset_);
+            if ((uintptr_t)data == (uintptr_t)-1)
+                std::abort();
+            return data;
+        }
+
+        void commit(void* data, size_t offset, size_t size) {
+            struct stat st;
+            if (fstat(fd_, &st) != 0)
+                std::abort();
+            if (st.st_size < offset_ + (off_t)(offset + size) && ftruncate(fd_, offset_ + offset + size) != 0)
+                std::abort();
+
+            if (mprotect((uint8_t*)data + offset, size, PROT_READ | PROT_WRITE) != 0)
+                std::abort();
+            madvise((uint8_t*)data + offset, size, MADV_WILLNEED);
+        }
+
+        void unmap(void* data, size_t capacity) { munmap(data, capacity); }
+
+    private:
+        int fd_;
+        off_t offset_;
+    };
+
+    template< typename T, size_t Capacity = 1 << 30, typename Mapping = anonymous_mapping > class mmapped_array {
+        // Pages are committed in doubling steps behind the committed_
+        // watermark, so emplace_back pays a single comparison on the hot
+        // path and writes past Capacity abort instead of faulting.
+        static constexpr size_t commit_chunk = 1 << 21;
+        static constexpr size_t page_size = 4096;
+
+        Mapping mapping_;
         std::atomic<size_t> size_ = 0;
         void* data_ = nullptr;
+        size_t capacity_ = 0;
+        size_t committed_ = 0;
+        size_t committed_bytes_ = 0;
+
+        void grow(size_t size) {
+            size_t required = (size + 1) * sizeof(T);
+            if (required > capacity_)
+                std::abort();
+            size_t bytes = std::max(committed_bytes_ * 2, commit_chunk);
+            while (bytes < required)
+                bytes *= 2;
+            bytes = std::min(bytes, capacity_);
+            mapping_.commit(data_, committed_bytes_, bytes - committed_bytes_);
+            committed_bytes_ = bytes;
+            committed_ = bytes / sizeof(T);
+        }
 
         T* at(size_t n) {
             T* ptr = reinterpret_cast<T*>(data_) + n;
@@ -38,19 +170,22 @@ namespace containers {
         using value_type = T;
 
         class reader_state {
-            template< typename, size_t > friend class mmapped_array;
-            size_t size;
+            template< typename, size_t, typename > friend class mmapped_array;
+            size_t size = 0;
         };
 
-        mmapped_array() {
-            data_ = mmap(0, capacity_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-            if ((uintptr_t)data_ == (uintptr_t)-1)
-                std::abort();
+        mmapped_array(): mmapped_array(Mapping()) {}
 
-            madvise(data_, capacity_, MADV_WILLNEED);
+        // The size covers re-mapping persisted data: elements below it are
+        // treated as constructed and become readable immediately.
+        mmapped_array(Mapping mapping, size_t size = 0, size_t capacity = Capacity):
+            mapping_(std::move(mapping)), size_(size), capacity_(capacity) {
+            data_ = mapping_.reserve(capacity_);
+            if (size)
+                grow(size - 1);
         }
 
-        ~mmapped_array() { 
+        ~mmapped_array() {
             if (!std::is_trivially_destructible_v<T>) {
                 size_t size = size_.load(std::memory_order_relaxed);
                 if (size) {
@@ -59,16 +194,92 @@ namespace containers {
                     } while(size);
                 }
             }    
-            munmap(data_, capacity_);
+            mapping_.unmap(data_, capacity_);
         }
 
         template< typename... Args > size_t emplace_back(Args&&... args) {
             size_t size = size_.load(std::memory_order_relaxed);
+            if (size == committed_)
+                grow(size);
             new(reinterpret_cast<T*>(data_) + size) T{std::forward<Args>(args)...};
             size_.store(size + 1, std::memory_order_release);
             return size + 1;
         }
 
+        size_t capacity() const { return capacity_ / sizeof(T); }
+
+        // Advises the kernel that [first, last) is about to be scanned
+        // sequentially, so pages are faulted in ahead of the reader instead
+        // of one stall at a time. Indices like read(); the range is clamped
+        // to the published size, which commit() precedes, so a reader may
+        // call this concurrently with the writer.
+        void prefetch(size_t first, size_t last) {
+            size_t published = size_.load(std::memory_order_acquire) * sizeof(T);
+            size_t begin = (first * sizeof(T)) & ~(page_size - 1);
+            size_t end = std::min((last * sizeof(T) + page_size - 1) & ~(page_size - 1), published);
+            if (begin >= end)
+                return;
+            madvise((uint8_t*)data_ + begin, end - begin, MADV_SEQUENTIAL);
+            madvise((uint8_t*)data_ + begin, end - begin, MADV_WILLNEED);
+        }
+
+        // Background fault-in for cold scans: a toucher thread stays
+        // ahead_pages ahead of the reader's cursor, overlapping page faults
+        // with the reader's compute. The reader publishes its position into
+        // the cursor it registered; the thread stops on destruction.
+        class scan_prefetcher {
+        public:
+            scan_prefetcher(mmapped_array& array, const std::atomic<size_t>& cursor, size_t ahead_pages = 64):
+                array_(array), cursor_(cursor), ahead_((ahead_pages * page_size) / sizeof(T)) {
+                thread_ = std::thread([this] { run(); });
+            }
+
+            ~scan_prefetcher() {
+                stop_.store(true, std::memory_order_relaxed);
+                thread_.join();
+            }
+
+            scan_prefetcher(const scan_prefetcher&) = delete;
+            scan_prefetcher& operator = (const scan_prefetcher&) = delete;
+
+        private:
+            void run() {
+                size_t touched = cursor_.load(std::memory_order_relaxed);
+                while (!stop_.load(std::memory_order_relaxed)) {
+                    size_t cursor = cursor_.load(std::memory_order_relaxed);
+                    size_t limit = std::min(array_.size(), cursor + ahead_);
+                    touched = std::max(touched, cursor);
+                    if (touched >= limit) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    array_.prefetch(touched, limit);
+                    // One read per page forces the fault-in that madvise
+                    // only hints at.
+                    auto* data = reinterpret_cast<const volatile uint8_t*>(array_.data_);
+                    for (size_t byte = touched * sizeof(T); byte < limit * sizeof(T); byte += page_size)
+                        (void)data[byte];
+                    touched = limit;
+                }
+            }
+
+            mmapped_array& array_;
+            const std::atomic<size_t>& cursor_;
+            size_t ahead_;
+            std::atomic<bool> stop_ = false;
+            std::thread thread_;
+        };
+
+        // The storage is contiguous, so plain pointers are the natural
+        // random-access iterators; end() snapshots the published size.
+        using iterator = T*;
+
+        iterator begin() { return reinterpret_cast<T*>(data_); }
+        iterator end() { return begin() + size_.load(std::memory_order_acquire); }
+
+        size_t size() const { return size_.load(std::memory_order_acquire); }
+        bool empty() const { return size_.load(std::memory_order_acquire) == 0; }
+
 
         size_t push_back(const T& value) { return emplace_back(value); }
         size_t push_back(T&& value) { return emplace_back(std::move(value)); }
@@ -0,0 +1,214 @@
+//
+// This file is part of containers project <https://github.com/romanpauk/containers>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace containers {
+    // Bounded wait-free single-producer single-consumer ring buffer. Head and
+    // tail live on their own cache lines together with each side's cached
+    // view of the opposite cursor, so the cursors are re-read only when the
+    // buffer looks full or empty. The batch push/consume overloads publish
+    // the cursor once per batch with a single release store, the same way
+    // growable_array::append publishes size_.
+    template< typename T, size_t Capacity > class ring_buffer {
+        static_assert((Capacity & (Capacity - 1)) == 0);
+
+        T* slot(size_t n) { return reinterpret_cast<T*>(&storage_) + (n & (Capacity - 1)); }
+
+        alignas(64) std::atomic<size_t> head_ = 0;
+        size_t tail_cache_ = 0; // consumer-owned view of tail_
+        alignas(64) std::atomic<size_t> tail_ = 0;
+        size_t head_cache_ = 0; // producer-owned view of head_
+        alignas(64) std::aligned_storage_t<sizeof(T) * Capacity, alignof(T)> storage_;
+
+    public:
+        using value_type = T;
+
+        ring_buffer() = default;
+        ring_buffer(const ring_buffer&) = delete;
+        ring_buffer& operator = (const ring_buffer&) = delete;
+
+        ~ring_buffer() {
+            if (!std::is_trivially_destructible_v<T>) {
+                size_t tail = tail_.load(std::memory_order_relaxed);
+                for (size_t head = head_.load(std::memory_order_relaxed); head != tail; ++head)
+                    slot(head)->~T();
+            }
+        }
+
+        template< typename... Args > bool emplace(Args&&... args) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_cache_ == Capacity) {
+                head_cache_ = head_.load(std::memory_order_acquire);
+                if (tail - head_cache_ == Capacity)
+                    return false;
+            }
+            new (slot(tail)) T{std::forward<Args>(args)...};
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool push(const T& value) { return emplace(value); }
+        bool push(T&& value) { return emplace(std::move(value)); }
+
+        // Pushes as much of [first, last) as fits, returning the number of
+        // elements pushed. The tail is published once at the end.
+        template< typename It > size_t push(It first, It last) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            size_t n = tail;
+            while (first != last) {
+                if (n - head_cache_ == Capacity) {
+                    head_cache_ = head_.load(std::memory_order_acquire);
+                    if (n - head_cache_ == Capacity)
+                        break;
+                }
+                new (slot(n)) T{*first++};
+                ++n;
+            }
+            if (n != tail)
+                tail_.store(n, std::memory_order_release);
+            return n - tail;
+        }
+
+        bool pop(T& value) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_cache_) {
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                if (head == tail_cache_)
+                    return false;
+            }
+            value = std::move(*slot(head));
+            slot(head)->~T();
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Feeds up to max available elements to f, returning the number
+        // consumed. The head is published once at the end.
+        template< typename F > size_t consume(F&& f, size_t max = Capacity) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            size_t n = head;
+            while (n - head != max) {
+                if (n == tail_cache_) {
+                    tail_cache_ = tail_.load(std::memory_order_acquire);
+                    if (n == tail_cache_)
+                        break;
+                }
+                f(std::move(*slot(n)));
+                slot(n)->~T();
+                ++n;
+            }
+            if (n != head)
+                head_.store(n, std::memory_order_release);
+            return n - head;
+        }
+
+        static constexpr size_t capacity() { return Capacity; }
+
+        // Approximate under concurrency, exact when quiescent.
+        size_t size() const {
+            return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+        }
+
+        bool empty() const { return size() == 0; }
+    };
+
+    // Bounded multi-producer single-consumer ring buffer. Producers claim a
+    // slot with a CAS on the tail and publish the constructed element through
+    // a per-slot ready flag, the same scheme concurrent_growable_array blocks
+    // use, so producers only contend on the tail word. The consumer side is
+    // wait-free.
+    template< typename T, size_t Capacity > class mpsc_ring_buffer {
+        static_assert((Capacity & (Capacity - 1)) == 0);
+
+        T* slot(size_t n) { return reinterpret_cast<T*>(&storage_) + (n & (Capacity - 1)); }
+
+        alignas(64) std::atomic<size_t> head_ = 0;
+        alignas(64) std::atomic<size_t> tail_ = 0;
+        alignas(64) std::atomic<uint8_t> ready_[Capacity] = {};
+        std::aligned_storage_t<sizeof(T) * Capacity, alignof(T)> storage_;
+
+    public:
+        using value_type = T;
+
+        mpsc_ring_buffer() = default;
+        mpsc_ring_buffer(const mpsc_ring_buffer&) = delete;
+        mpsc_ring_buffer& operator = (const mpsc_ring_buffer&) = delete;
+
+        ~mpsc_ring_buffer() {
+            if (!std::is_trivially_destructible_v<T>) {
+                size_t tail = tail_.load(std::memory_order_relaxed);
+                for (size_t head = head_.load(std::memory_order_relaxed); head != tail; ++head)
+                    slot(head)->~T();
+            }
+        }
+
+        template< typename... Args > bool emplace(Args&&... args) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            do {
+                if (tail - head_.load(std::memory_order_acquire) == Capacity)
+                    return false;
+            } while (!tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed));
+            new (slot(tail)) T{std::forward<Args>(args)...};
+            ready_[tail & (Capacity - 1)].store(1, std::memory_order_release);
+            return true;
+        }
+
+        bool push(const T& value) { return emplace(value); }
+        bool push(T&& value) { return emplace(std::move(value)); }
+
+        bool pop(T& value) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            auto& ready = ready_[head & (Capacity - 1)];
+            if (!ready.load(std::memory_order_acquire))
+                return false; // empty, or the slot is claimed but not yet published
+            value = std::move(*slot(head));
+            slot(head)->~T();
+            ready.store(0, std::memory_order_relaxed);
+            // Producers acquire head_, so the ready reset above is visible
+            // before the slot can be claimed again.
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Feeds up to max published elements to f, returning the number
+        // consumed. The head is published once at the end.
+        template< typename F > size_t consume(F&& f, size_t max = Capacity) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            size_t n = head;
+            while (n - head != max) {
+                auto& ready = ready_[n & (Capacity - 1)];
+                if (!ready.load(std::memory_order_acquire))
+                    break;
+                f(std::move(*slot(n)));
+                slot(n)->~T();
+                ready.store(0, std::memory_order_relaxed);
+                ++n;
+            }
+            if (n != head)
+                head_.store(n, std::memory_order_release);
+            return n - head;
+        }
+
+        static constexpr size_t capacity() { return Capacity; }
+
+        size_t size() const {
+            return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+        }
+
+        bool empty() const { return size() == 0; }
+    };
+}
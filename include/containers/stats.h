@@ -0,0 +1,87 @@
+//
+// This file is part of containers project <https://github.com/romanpauk/containers>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace containers {
+    // Statistics policies for the containers. no_stats compiles every
+    // recording out, counting_stats keeps relaxed atomic counters scraped
+    // through read(). Counters are advisory: increments are relaxed and a
+    // snapshot is not an atomic cut across them.
+    struct no_stats {
+        struct snapshot {};
+
+        void hit() {}
+        void miss() {}
+        void insert() {}
+        void update() {}
+        void touch() {}
+        void eviction() {}
+        void append(size_t = 1) {}
+        void block_allocation() {}
+        void map_growth() {}
+
+        snapshot read() const { return {}; }
+    };
+
+    struct counting_stats {
+        struct snapshot {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t inserts = 0;
+            uint64_t updates = 0;
+            uint64_t touches = 0;
+            uint64_t evictions = 0;
+            uint64_t appends = 0;
+            uint64_t block_allocations = 0;
+            uint64_t map_growths = 0;
+        };
+
+        void hit() { add(hits_); }
+        void miss() { add(misses_); }
+        void insert() { add(inserts_); }
+        void update() { add(updates_); }
+        void touch() { add(touches_); }
+        void eviction() { add(evictions_); }
+        void append(size_t n = 1) { add(appends_, n); }
+        void block_allocation() { add(block_allocations_); }
+        void map_growth() { add(map_growths_); }
+
+        snapshot read() const {
+            snapshot s;
+            s.hits = hits_.load(std::memory_order_relaxed);
+            s.misses = misses_.load(std::memory_order_relaxed);
+            s.inserts = inserts_.load(std::memory_order_relaxed);
+            s.updates = updates_.load(std::memory_order_relaxed);
+            s.touches = touches_.load(std::memory_order_relaxed);
+            s.evictions = evictions_.load(std::memory_order_relaxed);
+            s.appends = appends_.load(std::memory_order_relaxed);
+            s.block_allocations = block_allocations_.load(std::memory_order_relaxed);
+            s.map_growths = map_growths_.load(std::memory_order_relaxed);
+            return s;
+        }
+
+    private:
+        static void add(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+            counter.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        std::atomic<uint64_t> hits_{0};
+        std::atomic<uint64_t> misses_{0};
+        std::atomic<uint64_t> inserts_{0};
+        std::atomic<uint64_t> updates_{0};
+        std::atomic<uint64_t> touches_{0};
+        std::atomic<uint64_t> evictions_{0};
+        std::atomic<uint64_t> appends_{0};
+        std::atomic<uint64_t> block_allocations_{0};
+        std::atomic<uint64_t> map_growths_{0};
+    };
+}
@@ -9,6 +9,414 @@
 
 #include <gtest/gtest.h>
 
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+template< typename Values > using open_addressing_map = containers::evictable_unordered_map<
+    int, int, std::hash<int>, std::equal_to<int>,
+    std::allocator< std::pair<const int, int> >,
+    containers::detail::lru_cache< std::pair<const int, int> >,
+    Values >;
+
+TEST(open_addressing, basic_operations) {
+    open_addressing_map< containers::open_addressing_values > cache;
+    ASSERT_EQ(cache.evictable(), cache.end());
+    cache.emplace(1, 100);
+    ASSERT_EQ(cache.evictable()->first, 1);
+    cache.emplace(2, 200);
+    ASSERT_EQ(cache.evictable()->first, 1);
+    cache.touch(cache.find(1));
+    ASSERT_EQ(cache.evictable()->first, 2);
+    cache.erase(cache.evictable());
+    ASSERT_EQ(cache.evictable()->first, 1);
+}
+
+TEST(open_addressing, emplace_find_erase) {
+    open_addressing_map< containers::open_addressing_values > cache;
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_EQ(cache.emplace(i, i * 10).second, true);
+        ASSERT_EQ(cache.emplace(i, 0).second, false);
+    }
+    ASSERT_EQ(cache.size(), 10000);
+    for (int i = 0; i < 10000; ++i) {
+        auto it = cache.find(i);
+        ASSERT_NE(it, cache.end());
+        ASSERT_EQ(it->second, i * 10);
+    }
+    for (int i = 0; i < 10000; i += 2)
+        cache.erase(cache.find(i));
+    ASSERT_EQ(cache.size(), 5000);
+    for (int i = 0; i < 10000; ++i)
+        ASSERT_EQ(cache.find(i) != cache.end(), i % 2 == 1);
+}
+
+namespace {
+    struct string_hash {
+        size_t operator()(std::string_view value) const { return std::hash<std::string_view>()(value); }
+    };
+}
+
+TEST(open_addressing, heterogeneous_find) {
+    containers::evictable_unordered_map< std::string, int, string_hash, std::equal_to<>,
+        std::allocator< std::pair<const std::string, int> >,
+        containers::detail::lru_cache< std::pair<const std::string, int> >,
+        containers::open_addressing_values > cache;
+    cache.emplace("one", 1);
+    cache.emplace("two", 2);
+    ASSERT_EQ(cache.find(std::string_view("one"))->second, 1); // no std::string is constructed
+    ASSERT_EQ(cache.find("two")->second, 2);
+    ASSERT_EQ(cache.find(std::string_view("three")), cache.end());
+    ASSERT_EQ(cache.evictable()->first, "one");
+    cache.touch(cache.find(std::string_view("one")));
+    ASSERT_EQ(cache.evictable()->first, "two");
+}
+
+TEST(pool_allocator, recycles_nodes) {
+    containers::detail::pool_allocator<size_t> allocator;
+    size_t* p1 = allocator.allocate(1);
+    size_t* p2 = allocator.allocate(1);
+    ASSERT_NE(p1, p2);
+    allocator.deallocate(p1, 1);
+    ASSERT_EQ(allocator.allocate(1), p1); // freelist hands the node back
+    allocator.deallocate(p2, 1);
+    allocator.deallocate(p1, 1);
+
+    size_t* array = allocator.allocate(16); // arrays bypass the pool
+    allocator.deallocate(array, 16);
+}
+
+TEST(pool_allocator, emplace_erase_churn) {
+    containers::evictable_unordered_map< int, int > cache;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 1000; ++i)
+            cache.emplace(i, i);
+        for (int i = 0; i < 1000; ++i)
+            cache.erase(cache.evictable());
+        ASSERT_EQ(cache.empty(), true);
+    }
+}
+
+TEST(sampled, readonly_find_records_access) {
+    containers::evictable_unordered_map< int, int, std::hash<int>, std::equal_to<int>,
+        std::allocator< std::pair<const int, int> >,
+        containers::detail::sampled_lru_cache< std::pair<const int, int> > > cache;
+    cache.emplace(1, 100);
+    cache.emplace(2, 200);
+    cache.emplace(3, 300);
+    ASSERT_EQ(cache.evictable()->first, 1);
+    ASSERT_EQ(cache.find_readonly(1)->second, 100);
+    ASSERT_EQ(cache.evictable()->first, 2); // the drain moved 1 back to the front
+    ASSERT_EQ(cache.find_readonly(4), cache.end());
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i)
+                ASSERT_EQ(cache.find_readonly(1 + i % 3)->first, 1 + i % 3);
+        });
+    }
+    for (auto& reader: readers)
+        reader.join();
+    ASSERT_EQ(cache.evictable()->first, 2);
+}
+
+namespace {
+    struct test_clock {
+        using duration = std::chrono::steady_clock::duration;
+        using time_point = std::chrono::steady_clock::time_point;
+        static time_point now() { return now_; }
+        static inline time_point now_;
+    };
+}
+
+TEST(ttl, batched_expiry) {
+    containers::evictable_unordered_map< int, int, std::hash<int>, std::equal_to<int>,
+        std::allocator< std::pair<const int, int> >,
+        containers::detail::ttl_cache< std::pair<const int, int>, test_clock > > cache;
+    cache.cache().set_ttl(std::chrono::seconds(10));
+    std::vector<int> evicted;
+    cache.set_eviction_callback([&](const auto& value) { evicted.push_back(value.first); });
+
+    cache.emplace(1, 100);
+    cache.emplace(2, 200);
+    test_clock::now_ += std::chrono::seconds(5);
+    cache.emplace(3, 300);
+
+    ASSERT_EQ(cache.expire(test_clock::now()), 0);
+    test_clock::now_ += std::chrono::seconds(6);
+    ASSERT_EQ(cache.expire(test_clock::now()), 2);
+    ASSERT_EQ(evicted, (std::vector<int>{1, 2}));
+    ASSERT_EQ(cache.find(1), cache.end());
+    ASSERT_NE(cache.find(3), cache.end()); // find refreshes the deadline
+
+    test_clock::now_ += std::chrono::seconds(20);
+    ASSERT_EQ(cache.expire(test_clock::now()), 1);
+    ASSERT_EQ(cache.empty(), true);
+}
+
+TEST(ttl, expires_only_stale_entries) {
+    // The expired batch must end at its own tail: the first node moved into
+    // it used to keep its stale next pointer at an unexpired neighbor, so
+    // the expire() walk erased live entries.
+    containers::evictable_unordered_map< int, int, std::hash<int>, std::equal_to<int>,
+        std::allocator< std::pair<const int, int> >,
+        containers::detail::ttl_cache< std::pair<const int, int>, test_clock > > cache;
+    cache.cache().set_ttl(std::chrono::seconds(10));
+    std::vector<int> evicted;
+    cache.set_eviction_callback([&](const auto& value) { evicted.push_back(value.first); });
+
+    cache.emplace(1, 100);
+    test_clock::now_ += std::chrono::seconds(5);
+    cache.emplace(2, 200);
+    cache.emplace(3, 300);
+
+    test_clock::now_ += std::chrono::seconds(6);
+    ASSERT_EQ(cache.expire(test_clock::now()), 1);
+    ASSERT_EQ(evicted, (std::vector<int>{1}));
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_NE(cache.find(2), cache.end());
+    ASSERT_NE(cache.find(3), cache.end());
+
+    test_clock::now_ += std::chrono::seconds(20);
+    ASSERT_EQ(cache.expire(test_clock::now()), 2);
+    ASSERT_EQ(cache.empty(), true);
+}
+
+TEST(clock, basic_operations) {
+    containers::evictable_unordered_map< int, int, std::hash<int>, std::equal_to<int>,
+        std::allocator< std::pair<const int, int> >,
+        containers::detail::clock_cache< std::pair<const int, int> > > cache;
+    ASSERT_EQ(cache.evictable(), cache.end());
+    cache.emplace(1, 100);
+    cache.emplace(2, 200);
+    cache.emplace(3, 300);
+    ASSERT_EQ(cache.evictable()->first, 1);
+    cache.touch(cache.find(1));
+    ASSERT_EQ(cache.evictable()->first, 2); // the hand skips 1, clearing its bit
+    cache.erase(cache.evictable());
+    ASSERT_EQ(cache.evictable()->first, 3);
+    cache.erase(cache.evictable());
+    ASSERT_EQ(cache.evictable()->first, 1);
+}
+
+TEST(bounded, evicts_inline) {
+    containers::evictable_unordered_map< int, int > cache;
+    std::vector<int> evicted;
+    cache.set_eviction_callback([&](const auto& value) { evicted.push_back(value.first); });
+    cache.set_capacity(2);
+
+    cache.emplace(1, 100);
+    cache.emplace(2, 200);
+    ASSERT_EQ(evicted.size(), 0);
+    cache.emplace(3, 300);
+    ASSERT_EQ(evicted, std::vector<int>{1});
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.find(1), cache.end());
+
+    cache.touch(2);
+    cache.emplace(4, 400);
+    ASSERT_EQ(evicted, (std::vector<int>{1, 3}));
+
+    cache.set_capacity(1);
+    ASSERT_EQ(cache.size(), 1);
+    ASSERT_EQ(evicted, (std::vector<int>{1, 3, 2}));
+    ASSERT_NE(cache.find(4), cache.end());
+}
+
+TEST(sharded, basic_operations) {
+    containers::sharded_evictable_unordered_map< int, int > cache;
+    ASSERT_EQ(cache.evictable(), std::nullopt);
+    ASSERT_EQ(cache.emplace(1, 100), true);
+    ASSERT_EQ(cache.emplace(1, 200), false);
+    ASSERT_EQ(cache.find(1), 100);
+    ASSERT_EQ(cache.find(2), std::nullopt);
+    ASSERT_EQ(cache.size(), 1);
+    ASSERT_NE(cache.evictable(), std::nullopt);
+    ASSERT_EQ(cache.erase(*cache.evictable()), 1);
+    ASSERT_EQ(cache.empty(), true);
+}
+
+TEST(sharded, emplace_find_multithreaded) {
+    containers::sharded_evictable_unordered_map< int, int > cache;
+    const int threads = 4;
+    const int count = 10000;
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&, t] {
+            for (int i = t * count; i < (t + 1) * count; ++i)
+                cache.emplace(i, i);
+        });
+    }
+    for (auto& writer: writers)
+        writer.join();
+
+    ASSERT_EQ(cache.size(), threads * count);
+    for (int i = 0; i < threads * count; ++i)
+        ASSERT_EQ(cache.find(i), i);
+}
+
+TEST(snapshot, save_load_preserves_lru) {
+    containers::evictable_unordered_map< int, std::string > cache;
+    cache.emplace(1, "100");
+    cache.emplace(2, "200");
+    cache.emplace(3, "300");
+    cache.touch(cache.find(1)); // eviction order becomes 2, 3, 1
+
+    std::stringstream stream;
+    cache.save(stream);
+
+    containers::evictable_unordered_map< int, std::string > loaded;
+    loaded.load(stream);
+    ASSERT_EQ(loaded.size(), 3);
+    ASSERT_EQ(loaded.find(1)->second, "100"); // eviction order becomes 2, 3, 1 again
+    ASSERT_EQ(loaded.evictable()->first, 2);
+    loaded.erase(loaded.evictable());
+    ASSERT_EQ(loaded.evictable()->first, 3);
+    loaded.erase(loaded.evictable());
+    ASSERT_EQ(loaded.evictable()->first, 1);
+}
+
+TEST(snapshot, save_load_open_addressing) {
+    open_addressing_map< containers::open_addressing_values > cache;
+    for (int i = 0; i < 10000; ++i)
+        cache.emplace(i, i * 10);
+
+    std::stringstream stream;
+    cache.save(stream);
+
+    open_addressing_map< containers::open_addressing_values > loaded;
+    loaded.load(stream);
+    ASSERT_EQ(loaded.size(), 10000);
+    for (int i = 0; i < 10000; ++i)
+        ASSERT_EQ(loaded.find(i)->second, i * 10);
+    ASSERT_EQ(loaded.evictable()->first, 0);
+}
+
+TEST(stats, counts_map_events) {
+    containers::evictable_unordered_map< int, int, std::hash<int>, std::equal_to<int>,
+        containers::detail::pool_allocator< std::pair<const int, int> >,
+        containers::detail::lru_cache< std::pair<const int, int> >,
+        containers::unordered_values,
+        containers::counting_stats > cache;
+    cache.set_capacity(2);
+
+    cache.emplace(1, 100);
+    cache.emplace(2, 200);
+    cache.emplace(2, 201); // update
+    cache.emplace(3, 300); // evicts 1
+    cache.find(2);
+    cache.find(4);
+    cache.touch(3);
+
+    auto s = cache.stats();
+    ASSERT_EQ(s.inserts, 3);
+    ASSERT_EQ(s.updates, 1);
+    ASSERT_EQ(s.evictions, 1);
+    ASSERT_EQ(s.hits, 2); // find(2) and the find inside touch(3)
+    ASSERT_EQ(s.misses, 1);
+    ASSERT_EQ(s.touches, 1);
+    ASSERT_GT(cache.load_factor(), 0.f);
+}
+
+TEST(find_batch, mixed_hits_and_misses) {
+    containers::evictable_unordered_map< int, int > cache;
+    for (int i = 0; i < 100; ++i)
+        cache.emplace(i, i * 10);
+
+    std::vector<int> keys;
+    for (int i = 0; i < 200; ++i)
+        keys.push_back(i);
+    std::vector<decltype(cache)::iterator> results;
+    cache.find_batch(keys.begin(), keys.end(), std::back_inserter(results));
+
+    ASSERT_EQ(results.size(), keys.size());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_NE(results[i], cache.end());
+        ASSERT_EQ(results[i]->second, i * 10);
+    }
+    for (int i = 100; i < 200; ++i)
+        ASSERT_EQ(results[i], cache.end());
+}
+
+TEST(find_batch, touches_recency_and_prefetches_open_addressing) {
+    containers::evictable_unordered_map< int, int, std::hash<int>, std::equal_to<int>,
+        containers::detail::pool_allocator< std::pair<const int, int> >,
+        containers::detail::lru_cache< std::pair<const int, int> >,
+        containers::open_addressing_values,
+        containers::counting_stats > cache;
+    cache.emplace(1, 100);
+    cache.emplace(2, 200);
+    cache.emplace(3, 300);
+
+    std::vector<int> keys{1, 4};
+    std::vector<decltype(cache)::iterator> results;
+    cache.find_batch(keys.begin(), keys.end(), std::back_inserter(results));
+
+    ASSERT_NE(results[0], cache.end());
+    ASSERT_EQ(results[1], cache.end());
+    ASSERT_EQ(cache.evictable()->first, 2); // 1 was touched by the batch
+    ASSERT_EQ(cache.stats().hits, 1);
+    ASSERT_EQ(cache.stats().misses, 1);
+}
+
+TEST(compact_lru, basic_operations) {
+    containers::evictable_unordered_map< int, int, std::hash<int>, std::equal_to<int>,
+        containers::detail::pool_allocator< std::pair<const int, int> >,
+        containers::detail::compact_lru_cache< std::pair<const int, int> > > cache;
+    ASSERT_EQ(cache.evictable(), cache.end());
+    cache.emplace(1, 100);
+    ASSERT_EQ(cache.evictable()->first, 1);
+    cache.emplace(2, 200);
+    ASSERT_EQ(cache.evictable()->first, 1);
+    cache.emplace(3, 300);
+    ASSERT_EQ(cache.evictable()->first, 1);
+    cache.touch(cache.find(1));
+    ASSERT_EQ(cache.evictable()->first, 2);
+    cache.erase(cache.evictable());
+    ASSERT_EQ(cache.evictable()->first, 3);
+    cache.erase(cache.evictable());
+    ASSERT_EQ(cache.evictable()->first, 1);
+    cache.erase(cache.evictable());
+    ASSERT_EQ(cache.evictable(), cache.end());
+}
+
+TEST(compact_lru, slot_reuse) {
+    containers::evictable_unordered_map< int, int, std::hash<int>, std::equal_to<int>,
+        containers::detail::pool_allocator< std::pair<const int, int> >,
+        containers::detail::compact_lru_cache< std::pair<const int, int> > > cache;
+    cache.set_capacity(16);
+    for (int i = 0; i < 1000; ++i)
+        cache.emplace(i, i);
+    ASSERT_EQ(cache.size(), 16);
+    for (int i = 1000 - 16; i < 1000; ++i)
+        ASSERT_NE(cache.find(i), cache.end());
+    ASSERT_EQ(cache.evictable()->first, 1000 - 16);
+}
+
+TEST(compact_lru_segmented, basic_operations) {
+    containers::evictable_unordered_map< int, int, std::hash<int>, std::equal_to<int>,
+        containers::detail::pool_allocator< std::pair<const int, int> >,
+        containers::detail::compact_lru_segmented_cache< std::pair<const int, int> > > cache;
+    ASSERT_EQ(cache.evictable(), cache.end());
+    cache.emplace(1, 100);
+    cache.emplace(2, 200);
+    cache.emplace(3, 300);
+    // 1 is oldest in probation until touched into the protected segment
+    ASSERT_EQ(cache.evictable()->first, 1);
+    cache.touch(cache.find(1));
+    ASSERT_EQ(cache.evictable()->first, 2);
+    cache.touch(cache.find(2));
+    ASSERT_EQ(cache.evictable()->first, 3);
+    cache.touch(cache.find(3));
+    // all protected now, evict from the protected tail
+    ASSERT_EQ(cache.evictable()->first, 1);
+    cache.erase(cache.evictable());
+    ASSERT_EQ(cache.evictable()->first, 2);
+}
+
 TEST(lru, basic_operations) {
 
     containers::evictable_unordered_map< int, int > cache;
@@ -6,9 +6,20 @@
 //
 
 #include <containers/growable_array.h>
+#include <containers/allocators/arena_allocator.h>
+
+#if defined(__linux__)
+#include <containers/allocators/numa_allocator.h>
+#endif
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
 TEST(growable_array, basics) {
     containers::growable_array<size_t, std::allocator<size_t>, 1 > array;
     decltype(array)::reader_state state;
@@ -43,6 +54,359 @@ TEST(growable_array, emplace_back_trivial) {
     }
 }
 
+TEST(growable_array, append) {
+    containers::growable_array<size_t> array;
+    std::vector<size_t> batch;
+    size_t n = 0;
+    for (size_t size: {1, 7, 128, 1000, 4096}) {
+        batch.clear();
+        for (size_t i = 0; i < size; ++i)
+            batch.push_back(n + i);
+        ASSERT_EQ(array.append(batch.data(), batch.data() + batch.size()), n + size);
+        n += size;
+    }
+    ASSERT_EQ(array.size(), n);
+    for (size_t i = 0; i < n; ++i)
+        ASSERT_EQ(array[i], i);
+}
+
+TEST(growable_array, append_nontrivial) {
+    containers::growable_array<std::string> array;
+    std::vector<std::string> batch;
+    for (size_t i = 0; i < 1000; ++i)
+        batch.push_back(std::to_string(i));
+    ASSERT_EQ(array.append(batch.begin(), batch.end()), 1000);
+    for (size_t i = 0; i < 1000; ++i)
+        ASSERT_EQ(array[i], std::to_string(i));
+}
+
+TEST(growable_array, reserve) {
+    containers::growable_array<size_t> array(1000);
+    ASSERT_GE(array.capacity(), 1000);
+    ASSERT_EQ(array.size(), 0);
+
+    for (size_t i = 0; i < 1000; ++i)
+        array.emplace_back(i);
+    ASSERT_EQ(array.size(), 1000);
+    for (size_t i = 0; i < 1000; ++i)
+        ASSERT_EQ(array[i], i);
+
+    size_t capacity = array.capacity();
+    array.reserve(100000, true);
+    ASSERT_GE(array.capacity(), 100000);
+    ASSERT_GT(array.capacity(), capacity);
+    for (size_t i = 0; i < 1000; ++i)
+        ASSERT_EQ(array[i], i);
+}
+
+TEST(growable_array, reserve_nontrivial_teardown) {
+    // Reserved blocks past the published size hold no constructed elements
+    // and must not be destroyed by clear() or the destructor.
+    containers::growable_array<std::string> array;
+    array.reserve(256);
+    array.emplace_back("x");
+    array.clear();
+
+    containers::growable_array<std::string> destroyed;
+    destroyed.reserve(256);
+    destroyed.emplace_back("y");
+}
+
+TEST(growable_array, iterators) {
+    containers::growable_array<size_t> array;
+    ASSERT_EQ(array.begin(), array.end());
+
+    for (size_t i = 0; i < 1000; ++i)
+        array.emplace_back(999 - i);
+    ASSERT_EQ(std::distance(array.begin(), array.end()), 1000);
+    ASSERT_EQ(std::accumulate(array.begin(), array.end(), size_t(0)), 1000 * 999 / 2);
+    ASSERT_EQ(array.begin()[500], 499);
+    ASSERT_EQ(*(array.end() - 1), 0);
+
+    std::sort(array.begin(), array.end());
+    for (size_t i = 0; i < 1000; ++i)
+        ASSERT_EQ(array[i], i);
+}
+
+TEST(arena_allocator, carves_and_releases) {
+    containers::detail::arena_allocator<size_t> arena;
+    size_t* a = arena.allocate(100);
+    size_t* b = arena.allocate(100);
+    ASSERT_NE(a, b);
+    a[99] = 1;
+    b[99] = 2;
+    arena.deallocate(a, 100); // dropped, memory comes back at release()
+    arena.release();
+    size_t* c = arena.allocate(1 << 20); // larger than a chunk
+    c[(1 << 20) - 1] = 3;
+    arena.release();
+}
+
+TEST(growable_array, arena_block_teardown) {
+    using block = containers::detail::growable_array_block<size_t, 128>;
+    containers::growable_array<size_t, std::allocator<size_t>, 128, 8, block,
+        containers::detail::arena_allocator<block>> array;
+
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < 10000; ++i)
+            array.emplace_back(i);
+        for (size_t i = 0; i < 10000; ++i)
+            ASSERT_EQ(array[i], i);
+        array.clear(); // bulk: releases arena chunks instead of per-block frees
+        ASSERT_EQ(array.size(), 0);
+    }
+}
+
+TEST(growable_array, reader_state_follows_map_growth) {
+    containers::growable_array<size_t> array;
+    decltype(array)::reader_state state;
+
+    // Interleaved appends and cached reads across several map replacements.
+    for (size_t i = 0; i < 100000; ++i) {
+        array.emplace_back(i);
+        ASSERT_EQ(array.read(state, i), i);
+        if (i % 1000 == 0) {
+            ASSERT_EQ(array.read(state, i / 2), i / 2);
+        }
+    }
+
+    // The cached block survives clear() only until the generation moves.
+    array.clear();
+    array.emplace_back(size_t(42));
+    ASSERT_EQ(array.read(state, 0), 42);
+}
+
+TEST(growable_array, reader_state_follows_resize_down) {
+    containers::growable_array<size_t> array;
+    decltype(array)::reader_state state;
+
+    for (size_t i = 0; i < 1000; ++i)
+        array.emplace_back(i);
+    ASSERT_EQ(array.read(state, 999), 999);
+
+    // Blocks recycled by resize_down can come back under the same index
+    // with a different address; the generation bump re-reads the map.
+    array.resize_down(100);
+    for (size_t i = 100; i < 1000; ++i)
+        array.emplace_back(i * 2);
+    ASSERT_EQ(array.read(state, 999), 999 * 2);
+    ASSERT_EQ(array.read(state, 50), 50);
+}
+
+TEST(growable_array, stats) {
+    containers::growable_array<size_t, std::allocator<size_t>, 128, 8,
+        containers::detail::growable_array_block<size_t, 128>,
+        std::allocator<containers::detail::growable_array_block<size_t, 128>>,
+        containers::detail::deferred_allocator<uint8_t, std::allocator<size_t>>,
+        containers::counting_stats> array;
+
+    for (size_t i = 0; i < 1000; ++i)
+        array.emplace_back(i);
+    std::vector<size_t> batch(1000);
+    array.append(batch.data(), batch.data() + batch.size());
+
+    auto s = array.stats();
+    ASSERT_EQ(s.appends, 2000);
+    ASSERT_EQ(s.block_allocations, (2000 + 127) / 128);
+    ASSERT_GE(s.map_growths, 1);
+}
+
+TEST(growable_array, resize_down) {
+    containers::growable_array<std::string> array;
+    for (size_t i = 0; i < 1000; ++i)
+        array.emplace_back(std::to_string(i));
+
+    array.resize_down(300);
+    ASSERT_EQ(array.size(), 300);
+    for (size_t i = 0; i < 300; ++i)
+        ASSERT_EQ(array[i], std::to_string(i));
+
+    for (size_t i = 300; i < 600; ++i) // recycled blocks are reused
+        array.emplace_back(std::to_string(i));
+    ASSERT_EQ(array.size(), 600);
+    for (size_t i = 0; i < 600; ++i)
+        ASSERT_EQ(array[i], std::to_string(i));
+
+    array.pop_back_n(600);
+    ASSERT_EQ(array.empty(), true);
+    array.pop_back_n(1);
+    ASSERT_EQ(array.size(), 0);
+}
+
+TEST(growable_array, blocks) {
+    containers::growable_array<size_t> array;
+    ASSERT_EQ(array.blocks().begin(), array.blocks().end());
+
+    for (size_t i = 0; i < 1000; ++i)
+        array.emplace_back(i);
+
+    size_t n = 0;
+    for (auto span: array.blocks()) {
+        for (auto& value: span)
+            ASSERT_EQ(value, n++);
+    }
+    ASSERT_EQ(n, 1000);
+
+    n = 0;
+    array.for_each([&](size_t value) { ASSERT_EQ(value, n++); });
+    ASSERT_EQ(array.reduce(size_t(0), [](size_t a, size_t b) { return a + b; }), 1000 * 999 / 2);
+}
+
+TEST(epoch_allocator, reclaims_after_readers_pass) {
+    containers::detail::epoch_allocator<uint8_t, std::allocator<uint8_t>> allocator;
+    auto* reader = allocator.register_reader();
+
+    auto* p1 = allocator.allocate(16);
+    allocator.reclaim(p1, 16);
+    ASSERT_EQ(allocator.retired(), 1); // reader has not passed the retirement epoch
+
+    allocator.announce(*reader);
+    auto* p2 = allocator.allocate(16);
+    allocator.reclaim(p2, 16);
+    ASSERT_EQ(allocator.retired(), 1); // p1 freed, p2 awaits the reader
+
+    reader->release();
+    auto* p3 = allocator.allocate(16);
+    allocator.reclaim(p3, 16);
+    ASSERT_EQ(allocator.retired(), 0); // no active readers left
+}
+
+TEST(growable_array, epoch_reclamation) {
+    containers::growable_array<size_t, std::allocator<size_t>, 128, 2,
+        containers::detail::growable_array_block<size_t, 128>,
+        std::allocator<containers::detail::growable_array_block<size_t, 128>>,
+        containers::detail::epoch_allocator<uint8_t, std::allocator<size_t>>> array;
+
+    std::atomic<bool> done = false;
+    std::thread reader([&] {
+        decltype(array)::reader_state state;
+        while (!done.load(std::memory_order_relaxed)) {
+            size_t size = array.size();
+            for (size_t i = 0; i < size; ++i)
+                ASSERT_EQ(array.read(state, i), i);
+        }
+    });
+
+    for (size_t i = 0; i < 100000; ++i)
+        array.emplace_back(i);
+    done = true;
+    reader.join();
+}
+
+#if defined(__linux__)
+TEST(numa_allocator, interleaved_blocks) {
+    using allocator = containers::detail::numa_allocator<size_t>;
+    containers::growable_array<size_t, allocator> array(
+        allocator(containers::detail::numa_mode::interleave, 0x3));
+    for (size_t i = 0; i < 1000; ++i)
+        array.emplace_back(i);
+    for (size_t i = 0; i < 1000; ++i)
+        ASSERT_EQ(array[i], i);
+}
+#endif
+
+TEST(geometric_growable_array, basics) {
+    containers::geometric_growable_array<size_t> array;
+    decltype(array)::reader_state state;
+
+    ASSERT_EQ(array.empty(), true);
+    for (size_t i = 0; i < 3; ++i) // stays within the inline block
+        ASSERT_EQ(array.push_back(i), i + 1);
+    ASSERT_EQ(array.size(), 3);
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(array[i], i);
+        ASSERT_EQ(array.read(state, i), i);
+    }
+    array.clear();
+    ASSERT_EQ(array.empty(), true);
+}
+
+TEST(geometric_growable_array, emplace_back_nontrivial) {
+    containers::geometric_growable_array<std::string> array;
+    for (size_t i = 0; i < 10000; ++i) {
+        array.emplace_back(std::to_string(i));
+
+        for (size_t j = 0; j < i; ++j) {
+            ASSERT_EQ(array[j], std::to_string(j));
+        }
+    }
+}
+
+TEST(geometric_growable_array, tail_reader) {
+    containers::geometric_growable_array<size_t> array;
+    std::atomic<bool> done = false;
+    std::thread reader([&] {
+        decltype(array)::reader_state state;
+        while (!done.load(std::memory_order_relaxed)) {
+            size_t size = array.size();
+            for (size_t i = 0; i < size; ++i)
+                ASSERT_EQ(array.read(state, i), i);
+        }
+    });
+
+    for (size_t i = 0; i < 100000; ++i)
+        array.emplace_back(i);
+    done = true;
+    reader.join();
+}
+
+TEST(concurrent_growable_array, basics) {
+    containers::concurrent_growable_array<size_t, std::allocator<size_t>, 1 > array;
+    decltype(array)::reader_state state;
+
+    for(int i = 0; i < 3; ++i) {
+        ASSERT_EQ(array.empty(), true);
+        ASSERT_EQ(array.size(), 0);
+        ASSERT_EQ(array.push_back(1), 1);
+        ASSERT_EQ(array.empty(), false);
+        ASSERT_EQ(array.size(), 1);
+        ASSERT_EQ(array[0], 1);
+        ASSERT_EQ(array.read(state, 0), 1);
+
+        ASSERT_EQ(array.push_back(2), 2);
+        ASSERT_EQ(array.size(), 2);
+        ASSERT_EQ(array[1], 2);
+        ASSERT_EQ(array.read(state, 1), 2);
+
+        array.clear();
+        state = {};
+    }
+}
+
+TEST(concurrent_growable_array, const_access) {
+    containers::concurrent_growable_array<size_t> array;
+    for (size_t i = 0; i < 1000; ++i)
+        array.emplace_back(i);
+
+    const auto& const_array = array;
+    for (size_t i = 0; i < 1000; ++i)
+        ASSERT_EQ(const_array[i], i);
+}
+
+TEST(concurrent_growable_array, emplace_back_multithreaded) {
+    containers::concurrent_growable_array<size_t> array;
+    const size_t threads = 4;
+    const size_t count = 10000;
+
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < threads; ++t) {
+        writers.emplace_back([&, t] {
+            for (size_t i = 0; i < count; ++i)
+                array.emplace_back(t * count + i);
+        });
+    }
+    for (auto& writer: writers)
+        writer.join();
+
+    ASSERT_EQ(array.size(), threads * count);
+    std::vector<size_t> values;
+    for (size_t i = 0; i < threads * count; ++i)
+        values.push_back(array[i]);
+    std::sort(values.begin(), values.end());
+    for (size_t i = 0; i < threads * count; ++i)
+        ASSERT_EQ(values[i], i);
+}
+
 TEST(growable_array, emplace_back_nontrivial) {
     containers::growable_array<std::string> array;
     for (size_t i = 0; i < 10000; ++i) {
@@ -0,0 +1,67 @@
+//
+// This file is part of containers project <https://github.com/romanpauk/containers>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <containers/indexed_array.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+TEST(indexed_array, basics) {
+    containers::indexed_array<std::string, size_t> array;
+    decltype(array)::reader_state state;
+
+    ASSERT_EQ(array.empty(), true);
+    ASSERT_EQ(array.read(state, "1"), nullptr);
+
+    ASSERT_EQ(array.emplace("1", 100), true);
+    ASSERT_EQ(array.emplace("1", 101), false);
+    ASSERT_EQ(array.emplace("2", 200), true);
+    ASSERT_EQ(array.size(), 2);
+
+    ASSERT_EQ(*array.read(state, "1"), 100);
+    ASSERT_EQ(*array.read(state, "2"), 200);
+    ASSERT_EQ(array.read(state, "3"), nullptr);
+    ASSERT_EQ(*array.find("1"), 100);
+
+    array.clear();
+    ASSERT_EQ(array.empty(), true);
+    ASSERT_EQ(array.read(state, "1"), nullptr);
+}
+
+TEST(indexed_array, grows_through_rehash) {
+    containers::indexed_array<size_t, size_t> array;
+    decltype(array)::reader_state state;
+
+    for (size_t i = 0; i < 10000; ++i)
+        ASSERT_EQ(array.emplace(i, i * 10), true);
+    for (size_t i = 0; i < 10000; ++i)
+        ASSERT_EQ(*array.read(state, i), i * 10);
+}
+
+TEST(indexed_array, concurrent_reader) {
+    containers::indexed_array<size_t, size_t> array;
+    const size_t count = 100000;
+
+    std::atomic<bool> done = false;
+    std::thread reader([&] {
+        decltype(array)::reader_state state;
+        size_t key = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            if (const size_t* value = array.read(state, key)) {
+                ASSERT_EQ(*value, key * 10);
+                key = (key + 1) % count;
+            }
+        }
+    });
+
+    for (size_t i = 0; i < count; ++i)
+        array.emplace(i, i * 10);
+    done = true;
+    reader.join();
+}
@@ -0,0 +1,117 @@
+//
+// This file is part of containers project <https://github.com/romanpauk/containers>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <containers/mmapped_array.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <numeric>
+
+#if defined(__linux__)
+
+TEST(mmapped_array, basics) {
+    containers::mmapped_array<size_t> array;
+    decltype(array)::reader_state state;
+
+    ASSERT_EQ(array.push_back(1), 1);
+    ASSERT_EQ(array[0], 1);
+    ASSERT_EQ(array.read(state, 0), 1);
+    ASSERT_EQ(array.push_back(2), 2);
+    ASSERT_EQ(array[1], 2);
+}
+
+TEST(mmapped_array, grows_past_committed_pages) {
+    containers::mmapped_array<size_t> array;
+    const size_t count = 1 << 20; // several commit steps past the first chunk
+    for (size_t i = 0; i < count; ++i)
+        array.emplace_back(i);
+    for (size_t i = 0; i < count; ++i)
+        ASSERT_EQ(array[i], i);
+}
+
+TEST(mmapped_array, iterators) {
+    containers::mmapped_array<size_t> array;
+    ASSERT_EQ(array.begin(), array.end());
+    for (size_t i = 0; i < 1000; ++i)
+        array.emplace_back(i);
+    ASSERT_EQ(array.size(), 1000);
+    ASSERT_EQ(std::accumulate(array.begin(), array.end(), size_t(0)), 1000 * 999 / 2);
+}
+
+TEST(mmapped_array, prefetch) {
+    containers::mmapped_array<size_t> array;
+    const size_t count = 1 << 18;
+    for (size_t i = 0; i < count; ++i)
+        array.emplace_back(i);
+    array.prefetch(0, count);
+    array.prefetch(count, count + 1000); // past the published size, clamped
+    for (size_t i = 0; i < count; ++i)
+        ASSERT_EQ(array[i], i);
+}
+
+TEST(mmapped_array, scan_prefetcher) {
+    containers::mmapped_array<size_t> array;
+    const size_t count = 1 << 18;
+    for (size_t i = 0; i < count; ++i)
+        array.emplace_back(i);
+
+    std::atomic<size_t> cursor = 0;
+    containers::mmapped_array<size_t>::scan_prefetcher prefetcher(array, cursor);
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(array[i], i);
+        cursor.store(i, std::memory_order_relaxed);
+    }
+}
+
+TEST(mmapped_array, numa_interleaved) {
+    containers::mmapped_array<size_t, 1 << 30, containers::numa_interleaved_mapping> array;
+    for (size_t i = 0; i < 1000; ++i)
+        array.emplace_back(i);
+    for (size_t i = 0; i < 1000; ++i)
+        ASSERT_EQ(array[i], i);
+}
+
+TEST(mmapped_array, file_mapping_round_trip) {
+    char path[] = "/tmp/containers_mmapped_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(fd, -1);
+
+    const size_t count = 100000;
+    {
+        containers::mmapped_array<size_t, 1 << 30, containers::file_mapping> array{
+            containers::file_mapping(fd)};
+        for (size_t i = 0; i < count; ++i)
+            array.emplace_back(i);
+    }
+    {
+        // Warm restart: re-map the persisted data with its element count
+        // instead of rebuilding, then keep appending.
+        containers::mmapped_array<size_t, 1 << 30, containers::file_mapping> array{
+            containers::file_mapping(fd), count};
+        ASSERT_EQ(array.size(), count);
+        for (size_t i = 0; i < count; ++i)
+            ASSERT_EQ(array[i], i);
+        array.emplace_back(count);
+        ASSERT_EQ(array[count], count);
+    }
+
+    close(fd);
+    unlink(path);
+}
+
+TEST(mmapped_array, runtime_capacity) {
+    containers::mmapped_array<size_t> array(containers::anonymous_mapping(), 0, size_t(1) << 32);
+    ASSERT_EQ(array.capacity(), (size_t(1) << 32) / sizeof(size_t));
+    for (size_t i = 0; i < 1000; ++i)
+        array.emplace_back(i);
+    for (size_t i = 0; i < 1000; ++i)
+        ASSERT_EQ(array[i], i);
+}
+
+#endif
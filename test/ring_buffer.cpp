@@ -0,0 +1,104 @@
+//
+// This file is part of containers project <https://github.com/romanpauk/containers>
+//
+// See LICENSE for license and copyright information
+// SPDX-License-Identifier: MIT
+//
+
+#include <containers/ring_buffer.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ring_buffer, basics) {
+    containers::ring_buffer<size_t, 4> buffer;
+    ASSERT_EQ(buffer.empty(), true);
+    ASSERT_EQ(buffer.capacity(), 4);
+
+    for (size_t i = 0; i < 4; ++i)
+        ASSERT_EQ(buffer.push(i), true);
+    ASSERT_EQ(buffer.push(4), false); // full
+    ASSERT_EQ(buffer.size(), 4);
+
+    size_t value;
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(buffer.pop(value), true);
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_EQ(buffer.pop(value), false); // empty
+}
+
+TEST(ring_buffer, batch_push_consume) {
+    containers::ring_buffer<std::string, 8> buffer;
+    std::vector<std::string> batch{"1", "2", "3", "4", "5"};
+    ASSERT_EQ(buffer.push(batch.begin(), batch.end()), 5);
+    ASSERT_EQ(buffer.push(batch.begin(), batch.end()), 3); // only 3 fit
+
+    std::vector<std::string> values;
+    ASSERT_EQ(buffer.consume([&](std::string value) { values.push_back(std::move(value)); }, 6), 6);
+    ASSERT_EQ(values, (std::vector<std::string>{"1", "2", "3", "4", "5", "1"}));
+    ASSERT_EQ(buffer.consume([&](std::string value) { values.push_back(std::move(value)); }), 2);
+    ASSERT_EQ(buffer.empty(), true);
+}
+
+TEST(ring_buffer, spsc_threaded) {
+    containers::ring_buffer<size_t, 128> buffer;
+    const size_t count = 100000;
+
+    std::thread producer([&] {
+        for (size_t i = 0; i < count;)
+            if (buffer.push(i))
+                ++i;
+    });
+
+    size_t expected = 0;
+    while (expected < count) {
+        buffer.consume([&](size_t value) {
+            ASSERT_EQ(value, expected++);
+        });
+    }
+    producer.join();
+}
+
+TEST(mpsc_ring_buffer, basics) {
+    containers::mpsc_ring_buffer<size_t, 4> buffer;
+    for (size_t i = 0; i < 4; ++i)
+        ASSERT_EQ(buffer.push(i), true);
+    ASSERT_EQ(buffer.push(4), false); // full
+
+    size_t value;
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(buffer.pop(value), true);
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_EQ(buffer.pop(value), false); // empty
+}
+
+TEST(mpsc_ring_buffer, mpsc_threaded) {
+    containers::mpsc_ring_buffer<size_t, 128> buffer;
+    const size_t threads = 4;
+    const size_t count = 10000;
+
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < threads; ++t) {
+        producers.emplace_back([&, t] {
+            for (size_t i = 0; i < count;)
+                if (buffer.push(t * count + i))
+                    ++i;
+        });
+    }
+
+    std::vector<size_t> values;
+    while (values.size() < threads * count)
+        buffer.consume([&](size_t value) { values.push_back(value); });
+    for (auto& producer: producers)
+        producer.join();
+
+    std::sort(values.begin(), values.end());
+    for (size_t i = 0; i < threads * count; ++i)
+        ASSERT_EQ(values[i], i);
+}